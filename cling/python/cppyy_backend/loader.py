@@ -5,10 +5,12 @@ from __future__ import print_function
 __all__ = [
     'load_cpp_backend',           # load libcppyy_backend
     'set_cling_compile_options',  # set EXTRA_CLING_ARGS envar
-    'ensure_precompiled_header'   # build precompiled header as necessary
+    'ensure_precompiled_header',  # build precompiled header as necessary
+    'ensure_user_precompiled_header'  # build PCH of user headers as necessary
 ]
 
 import ctypes
+import hashlib
 import os
 import platform
 import re
@@ -68,6 +70,12 @@ def load_cpp_backend():
      # distribution as there are too many varieties; create it now if needed
         ensure_precompiled_header()
 
+  # application headers to layer on top of the standard PCH, if any
+    user_headers = os.environ.get('CLING_USER_PCH_HEADERS', '')
+    if user_headers and not 'CLING_USER_PCH' in os.environ:
+        ensure_user_precompiled_header(
+            [h for h in user_headers.split(os.pathsep) if h], os.environ.get('CLING_USER_PCH_FLAGS', ''))
+
     names = list()
     try:
         bkname = os.environ['CPPYY_BACKEND_LIBRARY']
@@ -238,3 +246,100 @@ def ensure_precompiled_header(pchdir = '', pchname = ''):
          _warn_no_pch(str(e))
      finally:
          os.chdir(olddir)
+
+_include_re = re.compile(r'^\s*#\s*include\s*([<"])([^">]+)[">]', re.MULTILINE)
+def _hash_headers(digest, headers, incdirs):
+  # hash the contents of the given headers and, recursively, of the headers that
+  # they include and that can be found locally: quoted includes relative to the
+  # including file or on the include path, angle-bracketed ones on the include
+  # path only (system headers are part of the standard PCH and covered by its key)
+    seen = set()
+    todo = [os.path.abspath(h) for h in headers]
+    while todo:
+        fname = todo.pop(0)
+        if fname in seen:
+            continue
+        seen.add(fname)
+        with open(fname, 'rb') as f:
+            content = f.read()
+        digest.update(fname.encode('utf-8'))
+        digest.update(content)
+        for delim, inc in _include_re.findall(content.decode('utf-8', 'replace')):
+            dirs = incdirs if delim == '<' else [os.path.dirname(fname)]+incdirs
+            for d in dirs:
+                path = os.path.abspath(os.path.join(d, inc))
+                if os.path.exists(path):
+                    todo.append(path)
+                    break
+
+def _absolute_include_flags(flags):
+  # the PCH is built from a different directory, and relative include paths
+  # would be resolved differently by the interpreter, so make them absolute
+    result = list()
+    for f in flags.split():
+        if f.startswith('-I') and len(f) > 2 and not os.path.isabs(f[2:]):
+            f = '-I'+os.path.abspath(f[2:])
+        result.append(f)
+    return ' '.join(result)
+
+def ensure_user_precompiled_header(headers, flags = '', cachedir = ''):
+  # build a PCH of the given (application) headers, chained on top of the standard
+  # PCH so that only the headers themselves are compiled, in a cache directory keyed
+  # on their contents and the compile flags; it is picked up (through CLING_USER_PCH)
+  # when the interpreter starts, so this has to run before loading the backend
+    if not _precompiled_header_ensured:
+        ensure_precompiled_header()
+
+    basepch = os.environ.get('CLING_STANDARD_PCH', '')
+    if not basepch or basepch.lower() == 'none' or not os.path.exists(basepch):
+        warnings.warn('No standard precompiled header available to layer user headers on.')
+        return None
+
+    if not cachedir:
+        cachedir = os.environ.get('CLING_USER_PCH_CACHE', '')
+    if not cachedir:
+        cachedir = os.path.join(os.environ.get('XDG_CACHE_HOME', os.path.join(os.path.expanduser('~'), '.cache')), 'cppyy', 'pch')
+
+    olddir = os.getcwd()
+    try:
+        digest = hashlib.sha1()
+        st = os.stat(basepch)
+        digest.update(('%s:%d:%d\n' % (os.path.abspath(basepch), st.st_size, int(st.st_mtime))).encode('utf-8'))
+        flags = _absolute_include_flags(flags)
+        digest.update((os.environ.get('EXTRA_CLING_ARGS', '')+'\n'+flags+'\n').encode('utf-8'))
+        incdirs = [f[2:] for f in flags.split() if f.startswith('-I')]
+        _hash_headers(digest, headers, incdirs)
+        pchname = os.path.join(cachedir, 'user.%s.pch' % digest.hexdigest()[:20])
+
+        if not os.path.exists(pchname):
+            if not os.path.exists(cachedir):
+                os.makedirs(cachedir)
+            pkgpath = os.path.abspath(os.path.dirname(__file__))
+            os.chdir(pkgpath)
+            print('Building pre-compiled header for %d user header(s); this may take a moment ...' % len(headers))
+            makepch = os.path.join(pkgpath, 'etc', 'dictpch', 'makepch.py')
+            pyexe = sys.executable
+            if getattr(sys, 'frozen', False) or not ('python' in pyexe.lower() or 'pypy' in pyexe.lower()):
+                pyexe = 'python'
+            tmpname = '%s.%d.tmp' % (pchname, os.getpid())
+            cxxflags = ('-I'+os.path.join(pkgpath, 'include')+' '+flags).strip()
+            if subprocess.call([pyexe, makepch, '--chain', basepch, tmpname, cxxflags] + \
+                               [os.path.abspath(h) for h in headers]) != 0:
+                if os.path.exists(tmpname):
+                    os.remove(tmpname)
+                warnings.warn('Failed to build pre-compiled header for user headers.')
+                return None
+            os.rename(tmpname, pchname)    # atomic, in case of concurrent builds
+
+      # the interpreter has to use the same flags (macros, language options) as
+      # the PCH was built with, or it is rejected
+        os.environ['CLING_USER_PCH'] = pchname
+        os.environ['CLING_USER_PCH_FLAGS'] = flags
+        return pchname
+
+    except Exception as e:
+        warnings.warn('No pre-compiled header for user headers (%s).' % str(e))
+    finally:
+        os.chdir(olddir)
+
+    return None
@@ -0,0 +1,33 @@
+# Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.
+# All rights reserved.
+#
+# For the licensing terms see $ROOTSYS/LICENSE.
+# For the list of contributors see $ROOTSYS/README/CREDITS.
+
+# - Locate the lz4 library
+# Defines:
+#
+#  LZ4_FOUND
+#  LZ4_VERSION
+#  LZ4_INCLUDE_DIR
+#  LZ4_INCLUDE_DIRS (not cached)
+#  LZ4_LIBRARY
+#  LZ4_LIBRARIES (not cached)
+
+find_path(LZ4_INCLUDE_DIR NAMES lz4.h HINTS ${LZ4_DIR}/include $ENV{LZ4_DIR}/include)
+find_library(LZ4_LIBRARY NAMES lz4 HINTS ${LZ4_DIR}/lib $ENV{LZ4_DIR}/lib)
+
+if(LZ4_INCLUDE_DIR)
+  file(STRINGS ${LZ4_INCLUDE_DIR}/lz4.h LZ4_H REGEX "^#define LZ4_VERSION_(MAJOR|MINOR|RELEASE) +[0-9]+")
+  string(REGEX REPLACE ".+LZ4_VERSION_MAJOR +([0-9]+).+LZ4_VERSION_MINOR +([0-9]+).+LZ4_VERSION_RELEASE +([0-9]+).*" "\\1.\\2.\\3" LZ4_VERSION "${LZ4_H}")
+  unset(LZ4_H)
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4 REQUIRED_VARS LZ4_INCLUDE_DIR LZ4_LIBRARY VERSION_VAR LZ4_VERSION)
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
+
+if(LZ4_FOUND)
+  set(LZ4_INCLUDE_DIRS ${LZ4_INCLUDE_DIR})
+  set(LZ4_LIBRARIES ${LZ4_LIBRARY})
+endif()
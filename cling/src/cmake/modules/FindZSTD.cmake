@@ -0,0 +1,33 @@
+# Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.
+# All rights reserved.
+#
+# For the licensing terms see $ROOTSYS/LICENSE.
+# For the list of contributors see $ROOTSYS/README/CREDITS.
+
+# - Locate the zstd library
+# Defines:
+#
+#  ZSTD_FOUND
+#  ZSTD_VERSION
+#  ZSTD_INCLUDE_DIR
+#  ZSTD_INCLUDE_DIRS (not cached)
+#  ZSTD_LIBRARY
+#  ZSTD_LIBRARIES (not cached)
+
+find_path(ZSTD_INCLUDE_DIR NAMES zstd.h HINTS ${ZSTD_DIR}/include $ENV{ZSTD_DIR}/include)
+find_library(ZSTD_LIBRARY NAMES zstd HINTS ${ZSTD_DIR}/lib $ENV{ZSTD_DIR}/lib)
+
+if(ZSTD_INCLUDE_DIR)
+  file(STRINGS ${ZSTD_INCLUDE_DIR}/zstd.h ZSTD_H REGEX "^#define ZSTD_VERSION_(MAJOR|MINOR|RELEASE) +[0-9]+")
+  string(REGEX REPLACE ".+ZSTD_VERSION_MAJOR +([0-9]+).+ZSTD_VERSION_MINOR +([0-9]+).+ZSTD_VERSION_RELEASE +([0-9]+).*" "\\1.\\2.\\3" ZSTD_VERSION "${ZSTD_H}")
+  unset(ZSTD_H)
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZSTD REQUIRED_VARS ZSTD_INCLUDE_DIR ZSTD_LIBRARY VERSION_VAR ZSTD_VERSION)
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+
+if(ZSTD_FOUND)
+  set(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+  set(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+endif()
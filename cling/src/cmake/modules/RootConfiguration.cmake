@@ -112,7 +112,19 @@ else()
 endif()
 
 set(usezlib undef)
+set(uselz4 undef)
+set(usezstd undef)
 set(use${compression_default} define)
+if(lz4)
+  set(haslz4 define)
+else()
+  set(haslz4 undef)
+endif()
+if(zstd)
+  set(haszstd define)
+else()
+  set(haszstd undef)
+endif()
 
 # cloudflare zlib is available only on x86 and aarch64 platforms with Linux
 # for other platforms we have available builtin zlib 1.2.8
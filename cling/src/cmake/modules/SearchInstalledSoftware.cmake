@@ -52,6 +52,28 @@ if(builtin_zlib)
   add_subdirectory(builtins/zlib)
 endif()
 
+#---Check for LZ4 and ZSTD (optional compression algorithms) ------------------------
+foreach(pkg LZ4 ZSTD)
+  string(TOLOWER ${pkg} opt)
+  if(${opt})
+    message(STATUS "Looking for ${pkg}")
+    if(fail-on-missing)
+      find_package(${pkg} REQUIRED)
+    else()
+      find_package(${pkg})
+      if(NOT ${pkg}_FOUND)
+        message(STATUS "${pkg} not found. Switching off ${opt} option")
+        set(${opt} OFF CACHE BOOL "Disabled because ${pkg} not found (${${opt}_description})" FORCE)
+      endif()
+    endif()
+  endif()
+endforeach()
+
+if(compression_default MATCHES "lz4|zstd" AND NOT ${compression_default})
+  message(FATAL_ERROR "Default compression algorithm ${compression_default} is not available;"
+    " enable the '${compression_default}' option or select another compression_default.")
+endif()
+
 #---Check for cling and llvm --------------------------------------------------------
 
 set(CLING_INCLUDE_DIRS ${CMAKE_SOURCE_DIR}/interpreter/cling/include)
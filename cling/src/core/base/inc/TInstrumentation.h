@@ -0,0 +1,118 @@
+// @(#)root/base:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TInstrumentation
+#define ROOT_TInstrumentation
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TInstrumentation                                                     //
+//                                                                      //
+// Counters and timers for the hot paths of the interpreter and the     //
+// bindings. Always compiled in, but off by default, in which case a    //
+// probe costs a single (relaxed) load and a predictable branch.        //
+//                                                                      //
+// Environment:                                                         //
+//    CPPYY_INSTRUMENT=1          enable at startup                     //
+//    CPPYY_INSTRUMENT_TOPN=<n>   also keep per-name statistics and     //
+//                                report the top <n> names              //
+//    CPPYY_INSTRUMENT_DUMP=<f>   enable and write a report to file <f> //
+//                                (or to stderr for "-") at exit        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "RtypesCore.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace CppyyLegacy {
+
+class TInstrumentation {
+
+public:
+   enum ECategory {
+      kWrapperJIT,         // generation and compilation of call wrappers
+      kAutoLoad,
+      kAutoParse,
+      kLoadPCM,
+      kGetClass,           // TClass::GetClass by name, incl. normalization
+      kScopeLookup,        // Cppyy::GetScope beyond the memoized scopes
+      kScopeMiss,          // Cppyy::GetScope failures
+      kProcessLine,
+      kDeclare,
+      kNumCategories
+   };
+
+   struct TStat {
+      ULong64_t fCount   = 0;
+      ULong64_t fTotalNs = 0;      // inclusive of nested probes
+      ULong64_t fMaxNs   = 0;
+   };
+
+   struct TNamedStat {
+      std::string fName;
+      TStat       fStat;
+   };
+
+   /// Scoped timer; records its life time on destruction (if enabled when created).
+   class TTimer {
+   private:
+      ECategory   fCategory;
+      bool        fActive;
+      std::string fName;
+      std::chrono::steady_clock::time_point fStart;
+
+   public:
+      TTimer(ECategory cat, const char *name = nullptr) : fCategory(cat), fActive(IsEnabled()) {
+         if (fActive) {
+            if (name) fName = name;
+            fStart = std::chrono::steady_clock::now();
+         }
+      }
+      TTimer(const TTimer &) = delete;
+      TTimer &operator=(const TTimer &) = delete;
+      ~TTimer() { if (fActive) Stop(); }
+
+      void Stop();
+   };
+
+   static bool IsEnabled() { return fgEnabled.load(std::memory_order_relaxed); }
+   static bool SetEnabled(bool enable);
+   static void SetTopN(unsigned int n);
+   static unsigned int GetTopN();
+
+   static void Record(ECategory cat, ULong64_t ns, const char *name = nullptr);
+   static void Count(ECategory cat, const char *name = nullptr) {
+      if (IsEnabled()) Record(cat, 0, name);
+   }
+
+   static const char *GetCategoryName(ECategory cat);
+   static TStat GetStat(ECategory cat);
+   static std::vector<TNamedStat> GetTopNames(ECategory cat);
+   static void Reset();
+
+   static std::string Report();
+   static bool Dump(const char *fileName);
+
+   static void ForkPrepare();
+   static void ForkRelease();
+
+private:
+   static std::atomic<bool> fgEnabled;
+};
+
+} // namespace CppyyLegacy
+
+#endif // ROOT_TInstrumentation
@@ -0,0 +1,289 @@
+// @(#)root/base:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TInstrumentation
+\ingroup Base
+
+Counters and timers for the hot paths of the interpreter and the bindings.
+
+Per category, the number of events, and the total and maximum time spent
+are kept in atomics, so recording is lock-free. Per-name statistics (e.g.
+which classes were auto-loaded, or which wrappers took longest to compile)
+are only kept if a top-N has been selected; these are protected by a mutex
+and limited in size, with names beyond the limit folded into "(other)".
+
+The probes are left in place in production builds: when disabled, creating
+a TTimer or calling Count() amounts to a load of the enable flag and a
+branch on it.
+*/
+
+#include "TInstrumentation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace CppyyLegacy {
+
+std::atomic<bool> TInstrumentation::fgEnabled{false};
+
+namespace {
+
+struct TCategoryStat {
+   std::atomic<ULong64_t> fCount{0};
+   std::atomic<ULong64_t> fTotalNs{0};
+   std::atomic<ULong64_t> fMaxNs{0};
+};
+
+const char *gCategoryNames[TInstrumentation::kNumCategories] = {
+   "WrapperJIT", "AutoLoad", "AutoParse", "LoadPCM",
+   "GetClass", "ScopeLookup", "ScopeMiss", "ProcessLine", "Declare"
+};
+
+// maximum number of distinct names kept per category
+const size_t kMaxNames = 4096;
+
+TCategoryStat gStats[TInstrumentation::kNumCategories];
+std::atomic<unsigned int> gTopN{0};
+std::mutex gNamesMutex;
+std::unordered_map<std::string, TInstrumentation::TStat> gNames[TInstrumentation::kNumCategories];
+std::string gDumpFile;
+
+void DumpAtExit()
+{
+   TInstrumentation::Dump(gDumpFile.c_str());
+}
+
+struct TInstrumentationInit {
+   TInstrumentationInit() {
+      const char *env = std::getenv("CPPYY_INSTRUMENT");
+      if (env && env[0] && strcmp(env, "0") != 0)
+         TInstrumentation::SetEnabled(true);
+
+      env = std::getenv("CPPYY_INSTRUMENT_TOPN");
+      if (env && env[0])
+         TInstrumentation::SetTopN((unsigned int)std::strtoul(env, nullptr, 10));
+
+      env = std::getenv("CPPYY_INSTRUMENT_DUMP");
+      if (env && env[0]) {
+         gDumpFile = env;
+         TInstrumentation::SetEnabled(true);
+         std::atexit(DumpAtExit);
+      }
+   }
+} gInstrumentationInit;
+
+double ToMs(ULong64_t ns)
+{
+   return ns / 1.e6;
+}
+
+} // unnamed namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the time since construction; no-op for inactive timers.
+
+void TInstrumentation::TTimer::Stop()
+{
+   if (!fActive)
+      return;
+   fActive = false;
+   auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - fStart).count();
+   Record(fCategory, (ULong64_t)ns, fName.empty() ? nullptr : fName.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable recording; returns the previous setting.
+
+bool TInstrumentation::SetEnabled(bool enable)
+{
+   return fgEnabled.exchange(enable);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the number of names to report per category; 0 (the default)
+/// disables per-name statistics altogether.
+
+void TInstrumentation::SetTopN(unsigned int n)
+{
+   gTopN = n;
+}
+
+unsigned int TInstrumentation::GetTopN()
+{
+   return gTopN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record an event of the given duration (0 for plain counters).
+
+void TInstrumentation::Record(ECategory cat, ULong64_t ns, const char *name)
+{
+   if ((unsigned int)cat >= (unsigned int)kNumCategories)
+      return;
+
+   TCategoryStat &stat = gStats[cat];
+   stat.fCount.fetch_add(1, std::memory_order_relaxed);
+   stat.fTotalNs.fetch_add(ns, std::memory_order_relaxed);
+   ULong64_t prev = stat.fMaxNs.load(std::memory_order_relaxed);
+   while (prev < ns && !stat.fMaxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+      ;
+
+   if (name && gTopN.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(gNamesMutex);
+      auto &names = gNames[cat];
+      auto iname = names.find(name);
+      if (iname == names.end())
+         iname = names.emplace(names.size() < kMaxNames ? name : "(other)", TStat{}).first;
+      TStat &nstat = iname->second;
+      nstat.fCount += 1;
+      nstat.fTotalNs += ns;
+      nstat.fMaxNs = std::max(nstat.fMaxNs, ns);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *TInstrumentation::GetCategoryName(ECategory cat)
+{
+   if ((unsigned int)cat >= (unsigned int)kNumCategories)
+      return "<unknown>";
+   return gCategoryNames[cat];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a snapshot of the statistics of the given category.
+
+TInstrumentation::TStat TInstrumentation::GetStat(ECategory cat)
+{
+   TStat result;
+   if ((unsigned int)cat < (unsigned int)kNumCategories) {
+      const TCategoryStat &stat = gStats[cat];
+      result.fCount   = stat.fCount.load(std::memory_order_relaxed);
+      result.fTotalNs = stat.fTotalNs.load(std::memory_order_relaxed);
+      result.fMaxNs   = stat.fMaxNs.load(std::memory_order_relaxed);
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the top-N names of the given category, ordered by total time (or
+/// by count, for plain counters).
+
+std::vector<TInstrumentation::TNamedStat> TInstrumentation::GetTopNames(ECategory cat)
+{
+   std::vector<TNamedStat> result;
+   size_t topn = gTopN;
+   if (!topn || (unsigned int)cat >= (unsigned int)kNumCategories)
+      return result;
+
+   {
+      std::lock_guard<std::mutex> lock(gNamesMutex);
+      result.reserve(gNames[cat].size());
+      for (const auto &entry : gNames[cat])
+         result.push_back(TNamedStat{entry.first, entry.second});
+   }
+
+   auto cmp = [](const TNamedStat &a, const TNamedStat &b) {
+      if (a.fStat.fTotalNs != b.fStat.fTotalNs)
+         return a.fStat.fTotalNs > b.fStat.fTotalNs;
+      return a.fStat.fCount > b.fStat.fCount;
+   };
+   topn = std::min(topn, result.size());
+   std::partial_sort(result.begin(), result.begin() + topn, result.end(), cmp);
+   result.resize(topn);
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Clear all statistics; the enable and top-N settings are kept.
+
+void TInstrumentation::Reset()
+{
+   for (auto &stat : gStats) {
+      stat.fCount = 0;
+      stat.fTotalNs = 0;
+      stat.fMaxNs = 0;
+   }
+
+   std::lock_guard<std::mutex> lock(gNamesMutex);
+   for (auto &names : gNames)
+      names.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the lock on the per-name statistics before fork(), so that no other
+/// thread holds it in the child; to be released with ForkRelease() in both
+/// the parent and the child.
+
+void TInstrumentation::ForkPrepare()
+{
+   gNamesMutex.lock();
+}
+
+void TInstrumentation::ForkRelease()
+{
+   gNamesMutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a human readable report of all categories with events.
+
+std::string TInstrumentation::Report()
+{
+   std::string report;
+   char line[512];
+   snprintf(line, sizeof(line), "%-48s %12s %14s %12s\n", "category", "count", "total [ms]", "max [ms]");
+   report += line;
+
+   for (int icat = 0; icat < kNumCategories; ++icat) {
+      TStat stat = GetStat((ECategory)icat);
+      if (!stat.fCount)
+         continue;
+      snprintf(line, sizeof(line), "%-48s %12llu %14.3f %12.3f\n", gCategoryNames[icat],
+               (unsigned long long)stat.fCount, ToMs(stat.fTotalNs), ToMs(stat.fMaxNs));
+      report += line;
+
+      for (const auto &named : GetTopNames((ECategory)icat)) {
+         snprintf(line, sizeof(line), "  %-46.46s %12llu %14.3f %12.3f\n", named.fName.c_str(),
+                  (unsigned long long)named.fStat.fCount, ToMs(named.fStat.fTotalNs),
+                  ToMs(named.fStat.fMaxNs));
+         report += line;
+      }
+   }
+
+   return report;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the report to the given file, or to stderr if the name is "-";
+/// returns false if the file could not be written.
+
+bool TInstrumentation::Dump(const char *fileName)
+{
+   std::string report = Report();
+   if (!fileName || strcmp(fileName, "-") == 0) {
+      fputs(report.c_str(), stderr);
+      return true;
+   }
+
+   FILE *f = fopen(fileName, "w");
+   if (!f)
+      return false;
+   bool ok = fputs(report.c_str(), f) >= 0;
+   return (fclose(f) == 0) && ok;
+}
+
+} // namespace CppyyLegacy
@@ -90,6 +90,8 @@ extern PTR mmalloc_detach PARAMS ((PTR));
 
 extern int mmalloc_update_mapping PARAMS ((PTR));
 
+extern int mmalloc_share PARAMS ((PTR));
+
 extern int mmalloc_setkey PARAMS ((PTR, int, PTR));
 
 extern PTR mmalloc_getkey PARAMS ((PTR, int));
@@ -321,6 +321,7 @@ struct mdesc
 #define MMALLOC_DEVZERO  (1 << 0) /* Have mapped to /dev/zero */
 #define MMALLOC_INITIALIZED (1 << 1) /* Initialized mmalloc */
 #define MMALLOC_MMCHECK_USED (1 << 2) /* mmcheck() called already */
+#define MMALLOC_SHARED  (1 << 3) /* Shared between processes */
 
 /* Internal version of `mfree' used in `morecore'. */
 
@@ -344,6 +345,18 @@ extern struct mdesc *__mmalloc_default_mdp;
 
 extern PTR __mmalloc_mmap_morecore PARAMS ((struct mdesc *, int));
 
+/* Get core for a region. The morecore pointer in the descriptor is that of the
+   last process to attach, so for shared regions the mmap version is called
+   directly, as it may be mapped at a different address in this process. */
+
+#define MORECORE(mdp, size) \
+  (((mdp) -> flags & MMALLOC_SHARED) ? __mmalloc_mmap_morecore ((mdp), (size)) \
+                                     : (mdp) -> morecore ((mdp), (size)))
+
+#else
+
+#define MORECORE(mdp, size) ((mdp) -> morecore ((mdp), (size)))
+
 #endif
 
 /* Remap a mmalloc region that was previously mapped. */
@@ -53,7 +53,7 @@ PTR mmalloc_detach(PTR md)
       /* Now unmap all the pages associated with this region by asking for a
        negative increment equal to the current size of the region. */
 
-      if ((mtemp.morecore (&mtemp, mtemp.base - mtemp.breakval)) == NULL)
+      if ((MORECORE (&mtemp, mtemp.base - mtemp.breakval)) == NULL)
       {
          /* Update the original malloc descriptor with any changes */
          /* *(struct mdesc *) md = mtemp;  don't update, just unmapped (rdm) */
@@ -109,11 +109,11 @@ void __mmalloc_free(struct mdesc *mdp, PTR ptr)
          /* Now see if we can return stuff to the system.  */
          blocks = mdp -> heapinfo[block].free.size;
          if (blocks >= FINAL_FREE_BLOCKS && block + blocks == mdp -> heaplimit
-             && mdp -> morecore (mdp, 0) == ADDRESS (block + blocks))
+             && MORECORE (mdp, 0) == ADDRESS (block + blocks))
          {
             register size_t bytes = blocks * BLOCKSIZE;
             mdp -> heaplimit -= blocks;
-            mdp -> morecore (mdp, -(ptrdiff_t)bytes);
+            MORECORE (mdp, -(ptrdiff_t)bytes);
             mdp -> heapinfo[mdp -> heapinfo[block].free.prev].free.next
             = mdp -> heapinfo[block].free.next;
             mdp -> heapinfo[mdp -> heapinfo[block].free.next].free.prev
@@ -44,12 +44,12 @@ static PTR align(struct mdesc *mdp, size_t size)
   PTR result;
   unsigned long int adj;
 
-  result = mdp -> morecore (mdp, size);
+  result = MORECORE (mdp, size);
   adj = RESIDUAL (result, BLOCKSIZE);
   if (adj != 0)
     {
       adj = BLOCKSIZE - adj;
-      mdp -> morecore (mdp, adj);
+      MORECORE (mdp, adj);
       result = (char *) result + adj;
     }
   return (result);
@@ -101,7 +101,7 @@ static PTR morecore(struct mdesc *mdp, size_t size)
       newinfo = (mmalloc_info *) align (mdp, newsize * sizeof (mmalloc_info));
       if (newinfo == NULL)
       {
-         mdp -> morecore (mdp, -(ptrdiff_t)size);
+         MORECORE (mdp, -(ptrdiff_t)size);
          return (NULL);
       }
       memset ((PTR) newinfo, 0, newsize * sizeof (mmalloc_info));
@@ -249,7 +249,7 @@ PTR mmalloc(PTR md, size_t size)
             lastblocks = mdp -> heapinfo[block].free.size;
             if (mdp -> heaplimit != 0 &&
                 block + lastblocks == mdp -> heaplimit &&
-                mdp -> morecore (mdp, 0) == ADDRESS(block + lastblocks) &&
+                MORECORE (mdp, 0) == ADDRESS(block + lastblocks) &&
                 (morecore (mdp, (blocks - lastblocks) * BLOCKSIZE)) != NULL)
             {
                /* Which block we are extending (the `final free
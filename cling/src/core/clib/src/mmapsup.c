@@ -134,6 +134,13 @@ PTR __mmalloc_mmap_morecore(struct mdesc *mdp, int size)
         }
       else if (mdp -> breakval + size > mdp -> top)
         {
+          /* A region shared between processes can not grow, as the
+             other processes would not see the extended mapping. */
+          if (mdp -> flags & MMALLOC_SHARED)
+            {
+              return (result);
+            }
+
           /* The request would move us past the end of the currently
              mapped memory, so map in enough more memory to satisfy
              the request.  This means we also have to grow the mapped-to
@@ -273,6 +280,13 @@ PTR __mmalloc_remap_core(struct mdesc *mdp)
     base = mmap (mdp -> base, mdp -> top - mdp -> base,
                  PROT_READ | PROT_WRITE, MAP_SHARED /* | MAP_FIXED */,
                  mdp -> fd, 0);
+    /* the pointers in a writable region are only valid at its original
+       address, so fail rather than return a mapping elsewhere */
+    if (base != (char *)-1 && base != mdp -> base)
+      {
+        munmap (base, (size_t) (mdp -> top - mdp -> base));
+        base = (char *)-1;
+      }
 #else
     HANDLE hMap;
     hMap = CreateFileMapping(mdp -> fd, NULL, PAGE_READWRITE,
@@ -352,6 +366,21 @@ int mmalloc_update_mapping(PTR md)
   return (result);
 }
 
+/* Mark the region as shared between processes that attach it read-write.
+   Its size is then fixed to what is currently mapped: once it is full,
+   allocations fail rather than extend the mapping, which would be private to
+   the calling process. Returns 1 on success. */
+
+int mmalloc_share(PTR md)
+{
+  struct mdesc *mdp = (struct mdesc *)md;
+
+  if (mdp == NULL)
+    return 0;
+  mdp -> flags |= MMALLOC_SHARED;
+  return 1;
+}
+
 #else   /* defined(R__HAVE_MMAP) */
 
 int
@@ -361,4 +390,11 @@ mmalloc_update_mapping(md)
    return 0;
 }
 
+int
+mmalloc_share(md)
+  PTR md;
+{
+   return 0;
+}
+
 #endif  /* defined(R__HAVE_MMAP) */
@@ -0,0 +1,88 @@
+// @(#)root/metautils:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TClingRootmapIndex
+#define ROOT_TClingRootmapIndex
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TRootmapIndex                                                        //
+//                                                                      //
+// Binary companion of a text rootmap file, stored next to it as        //
+// "<name>.rootmap.idx". It holds the forward declarations, the table   //
+// of libraries and the autoload keys (in file order, with their kind   //
+// and library) in one block that is mapped into memory as-is, so that  //
+// no line parsing is needed when loading the rootmap. Lookups are      //
+// still served from the library map that the keys are entered into.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace CppyyLegacy {
+namespace TMetaUtils {
+
+class TRootmapIndex {
+public:
+   /// Key kinds, equal to the first letter of the text rootmap keywords.
+   enum EKind : char {
+      kClass = 'c', kNamespace = 'n', kTypedef = 't', kHeader = 'h', kEnum = 'e', kVar = 'v'
+   };
+
+   /// Key as collected for writing: kind, key, and index into the libraries.
+   struct Key {
+      char        fKind;
+      std::string fName;
+      uint32_t    fLib;
+   };
+
+   static const char *Extension() { return ".idx"; }
+   static bool Write(const std::string &fileName, const std::vector<std::string> &decls,
+                     const std::vector<std::string> &libs, const std::vector<Key> &keys);
+
+   TRootmapIndex() = default;
+   TRootmapIndex(const TRootmapIndex &) = delete;
+   TRootmapIndex &operator=(const TRootmapIndex &) = delete;
+   ~TRootmapIndex() { Close(); }
+
+   bool Open(const std::string &fileName);
+   void Close();
+   bool IsOpen() const { return fData != nullptr; }
+
+   uint32_t GetNumDecls() const;
+   std::string GetDecl(uint32_t idecl) const;
+   uint32_t GetNumLibs() const;
+   std::string GetLib(uint32_t ilib) const;
+   uint32_t GetNumKeys() const;
+   char GetKeyKind(uint32_t ikey) const;
+   const char *GetKeyName(uint32_t ikey, uint32_t &len) const;
+   uint32_t GetKeyLib(uint32_t ikey) const;
+
+private:
+   struct Header;
+   struct Record;
+
+   const Header *GetHeader() const { return (const Header *)fData; }
+   std::string GetString(uint32_t offset, uint32_t len) const;
+   const Record *GetRecords(uint32_t table) const;
+
+   const char       *fData = nullptr;    // mapped (or read) file content
+   size_t            fSize = 0;
+   bool              fMapped = false;
+   std::vector<char> fBuffer;            // content if it could not be mapped
+};
+
+} // namespace TMetaUtils
+} // namespace CppyyLegacy
+
+#endif // ROOT_TClingRootmapIndex
@@ -0,0 +1,280 @@
+// @(#)root/metautils:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class CppyyLegacy::TMetaUtils::TRootmapIndex
+Binary companion of a text rootmap file.
+
+Layout (native byte order, which is checked through the byte order mark):
+
+    Header                      magic, version, byte order mark, table sizes
+    Record[fNumDecls]           lines of the "{ decls }" section
+    Record[fNumLibs]            library lists, one per "[ ... ]" section
+    Record[fNumKeys]            autoload keys, in the order of the text
+    char[fStringsSize]          string pool referred to by the records
+
+The keys are entered into the library map of TCling one by one, as when
+reading the text, so lookups (autoloading, GetClassSharedLibs) are served
+from that map as before: the index only saves the parsing of the lines.
+
+Files that fail any of the consistency checks are ignored, in which case
+the text rootmap is read instead.
+*/
+
+#include "TClingRootmapIndex.h"
+
+#include <ROOT/RConfig.hxx>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef R__WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace CppyyLegacy {
+namespace TMetaUtils {
+
+static const char     gRootmapIndexMagic[8] = {'R', 'M', 'A', 'P', 'I', 'D', 'X', '\1'};
+static const uint32_t gRootmapIndexVersion = 2;
+static const uint32_t gRootmapIndexByteOrder = 0x01020304;
+
+struct TRootmapIndex::Header {
+   char     fMagic[8];
+   uint32_t fVersion;
+   uint32_t fByteOrder;    // gRootmapIndexByteOrder, as written
+   uint32_t fNumDecls;
+   uint32_t fNumLibs;
+   uint32_t fNumKeys;
+   uint32_t fStringsSize;
+};
+
+struct TRootmapIndex::Record {
+   uint32_t fOffset;       // into the string pool
+   uint32_t fLen;
+   uint32_t fLib;          // keys only
+   char     fKind;         // keys only
+   char     fPad[3];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write an index file, keeping the keys in the given (i.e. text) order, so
+/// that they are entered into the library map as when reading the text.
+/// Returns false on failure.
+
+bool TRootmapIndex::Write(const std::string &fileName, const std::vector<std::string> &decls,
+                          const std::vector<std::string> &libs, const std::vector<Key> &keys)
+{
+   std::string strings;
+   auto addString = [&strings](const std::string &s) {
+      Record r{};
+      r.fOffset = (uint32_t)strings.size();
+      r.fLen = (uint32_t)s.size();
+      strings += s;
+      return r;
+   };
+
+   std::vector<Record> records;
+   records.reserve(decls.size() + libs.size() + keys.size());
+   for (const auto &decl : decls)
+      records.push_back(addString(decl));
+   for (const auto &lib : libs)
+      records.push_back(addString(lib));
+   for (const auto &key : keys) {
+      Record r = addString(key.fName);
+      r.fLib = key.fLib;
+      r.fKind = key.fKind;
+      records.push_back(r);
+   }
+
+   Header h{};
+   memcpy(h.fMagic, gRootmapIndexMagic, sizeof(h.fMagic));
+   h.fVersion = gRootmapIndexVersion;
+   h.fByteOrder = gRootmapIndexByteOrder;
+   h.fNumDecls = (uint32_t)decls.size();
+   h.fNumLibs = (uint32_t)libs.size();
+   h.fNumKeys = (uint32_t)keys.size();
+   h.fStringsSize = (uint32_t)strings.size();
+
+   // Write through a temporary, so that readers never see a partial file.
+   std::string tmpName = fileName + ".tmp";
+   {
+      std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+      if (!out)
+         return false;
+      out.write((const char *)&h, sizeof(h));
+      out.write((const char *)records.data(), records.size() * sizeof(Record));
+      out.write(strings.data(), strings.size());
+      if (!out.good()) {
+         out.close();
+         std::remove(tmpName.c_str());
+         return false;
+      }
+   }
+   if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+      std::remove(tmpName.c_str());
+      return false;
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Map the given index file and check its consistency; returns false (and
+/// leaves the index closed) if it can not be used.
+
+bool TRootmapIndex::Open(const std::string &fileName)
+{
+   Close();
+
+#ifndef R__WIN32
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+   struct stat st;
+   if (::fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Header)) {
+      void *addr = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+         fData = (const char *)addr;
+         fSize = (size_t)st.st_size;
+         fMapped = true;
+      }
+   }
+   ::close(fd);
+#else
+   std::ifstream in(fileName, std::ios::binary);
+   if (in) {
+      fBuffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      if (fBuffer.size() >= sizeof(Header)) {
+         fData = fBuffer.data();
+         fSize = fBuffer.size();
+      }
+   }
+#endif
+   if (!fData)
+      return false;
+
+   const Header *h = GetHeader();
+   const size_t nrecords = (size_t)h->fNumDecls + h->fNumLibs + h->fNumKeys;
+   if (memcmp(h->fMagic, gRootmapIndexMagic, sizeof(h->fMagic)) != 0 ||
+       h->fVersion != gRootmapIndexVersion ||
+       h->fByteOrder != gRootmapIndexByteOrder ||
+       fSize != sizeof(Header) + nrecords * sizeof(Record) + h->fStringsSize) {
+      Close();
+      return false;
+   }
+
+   const Record *records = GetRecords(0);
+   for (size_t i = 0; i < nrecords; ++i) {
+      const Record &r = records[i];
+      if ((size_t)r.fOffset + r.fLen > h->fStringsSize ||
+          (h->fNumDecls + h->fNumLibs <= i && h->fNumLibs <= r.fLib)) {
+         Close();
+         return false;
+      }
+   }
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TRootmapIndex::Close()
+{
+#ifndef R__WIN32
+   if (fMapped)
+      ::munmap(const_cast<char *>(fData), fSize);
+#endif
+   fData = nullptr;
+   fSize = 0;
+   fMapped = false;
+   fBuffer.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the records of the given table (0: decls, 1: libs, 2: keys).
+
+const TRootmapIndex::Record *TRootmapIndex::GetRecords(uint32_t table) const
+{
+   const Record *records = (const Record *)(fData + sizeof(Header));
+   if (table > 0)
+      records += GetHeader()->fNumDecls;
+   if (table > 1)
+      records += GetHeader()->fNumLibs;
+   return records;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string TRootmapIndex::GetString(uint32_t offset, uint32_t len) const
+{
+   const Header *h = GetHeader();
+   const char *strings = fData + sizeof(Header) +
+      ((size_t)h->fNumDecls + h->fNumLibs + h->fNumKeys) * sizeof(Record);
+   return std::string(strings + offset, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRootmapIndex::GetNumDecls() const
+{
+   return fData ? GetHeader()->fNumDecls : 0;
+}
+
+std::string TRootmapIndex::GetDecl(uint32_t idecl) const
+{
+   const Record &r = GetRecords(0)[idecl];
+   return GetString(r.fOffset, r.fLen);
+}
+
+uint32_t TRootmapIndex::GetNumLibs() const
+{
+   return fData ? GetHeader()->fNumLibs : 0;
+}
+
+std::string TRootmapIndex::GetLib(uint32_t ilib) const
+{
+   const Record &r = GetRecords(1)[ilib];
+   return GetString(r.fOffset, r.fLen);
+}
+
+uint32_t TRootmapIndex::GetNumKeys() const
+{
+   return fData ? GetHeader()->fNumKeys : 0;
+}
+
+char TRootmapIndex::GetKeyKind(uint32_t ikey) const
+{
+   return GetRecords(2)[ikey].fKind;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the key, which is not null-terminated, and its length.
+
+const char *TRootmapIndex::GetKeyName(uint32_t ikey, uint32_t &len) const
+{
+   const Header *h = GetHeader();
+   const Record &r = GetRecords(2)[ikey];
+   len = r.fLen;
+   return fData + sizeof(Header) +
+      ((size_t)h->fNumDecls + h->fNumLibs + h->fNumKeys) * sizeof(Record) + r.fOffset;
+}
+
+uint32_t TRootmapIndex::GetKeyLib(uint32_t ikey) const
+{
+   return GetRecords(2)[ikey].fLib;
+}
+
+} // namespace TMetaUtils
+} // namespace CppyyLegacy
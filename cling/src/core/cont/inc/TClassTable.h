@@ -38,6 +38,9 @@ class TClassTable : public TObject {
 friend  void CppyyLegacy::ResetClassVersion(TClass*, const char*, Short_t);
 friend  class TROOT;
 
+public:
+   typedef void (*ProtoLoaderFunc_t)(const void *token);
+
 private:
    typedef CppyyLegacy::TMapTypeToClassRec IdMap_t;
 
@@ -49,12 +52,14 @@ private:
    static UInt_t       fgTally;
    static Bool_t       fgSorted;
    static UInt_t       fgCursor;
+   static ProtoLoaderFunc_t fgProtoLoader;
 
    TClassTable();
 
    static CppyyLegacy::TClassRec   *FindElementImpl(const char *cname, Bool_t insert);
    static CppyyLegacy::TClassRec   *FindElement(const char *cname, Bool_t insert=kFALSE);
    static void         SortTable();
+   static TProtoClass *LoadPendingProto(CppyyLegacy::TClassRec *r);
 
    static Bool_t CheckClassTableInit();
 
@@ -72,6 +77,7 @@ public:
                             Int_t pragmabits);
    static void          Add(TProtoClass *protoClass);
    static void          AddAlternate(const char *normname, const char *alternate);
+   static void          AddPendingProto(const char *cname, const void *token);
    static char         *At(UInt_t index);
    int                  Classes();
    static Bool_t        Check(const char *cname, std::string &normname);
@@ -85,6 +91,8 @@ public:
    static void          Init();
    static char         *Next();
    static void          Remove(const char *cname);
+   static void          SetProtoLoader(ProtoLoaderFunc_t loader);
+   static Bool_t        HasProtoLoader() { return fgProtoLoader != nullptr; }
    static void          Terminate();
 
    ClassDef(TClassTable,0)  //Table of known classes
@@ -54,6 +54,7 @@ UInt_t       TClassTable::fgSize;
 UInt_t       TClassTable::fgTally;
 Bool_t       TClassTable::fgSorted;
 UInt_t       TClassTable::fgCursor;
+TClassTable::ProtoLoaderFunc_t TClassTable::fgProtoLoader;
 TClassTable::IdMap_t *TClassTable::fgIdMap;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -61,7 +62,7 @@ TClassTable::IdMap_t *TClassTable::fgIdMap;
    class TClassRec {
    public:
       TClassRec(TClassRec *next) :
-        fName(0), fId(0), fDict(0), fInfo(0), fProto(0), fNext(next)
+        fName(0), fId(0), fDict(0), fInfo(0), fProto(0), fPendingProto(0), fNext(next)
       {}
 
       ~TClassRec() {
@@ -77,6 +78,7 @@ TClassTable::IdMap_t *TClassTable::fgIdMap;
       DictFuncPtr_t    fDict;
       const std::type_info *fInfo;
       TProtoClass     *fProto;
+      const void      *fPendingProto; // token for the loader of a deferred fProto
       TClassRec       *fNext;
    };
 
@@ -336,6 +338,7 @@ void TClassTable::Add(TProtoClass *proto)
 
    // check if already in table, if so return
    TClassRec *r = FindElementImpl(cname, kTRUE);
+   r->fPendingProto = 0;
    if (r->fName) {
       if (r->fProto) delete r->fProto;
       r->fProto = proto;
@@ -362,6 +365,52 @@ void TClassTable::Add(TProtoClass *proto)
    fgSorted = kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Register that the TProtoClass for the class with the given (normalized)
+/// name is available, but not yet deserialized. The loader set through
+/// SetProtoLoader() is called with the token on first access through
+/// GetProto() or GetProtoNorm(), and is expected to Add() the TProtoClass.
+
+void TClassTable::AddPendingProto(const char *cname, const void *token)
+{
+   if (!gClassTable)
+      new TClassTable;
+
+   TClassRec *r = FindElementImpl(cname, kTRUE);
+   if (!r->fName) {
+      r->fName = StrDup(cname);
+      r->fId   = 0;
+      r->fBits = 0;
+      r->fDict = 0;
+      r->fInfo = 0;
+      fgSorted = kFALSE;
+   }
+   if (!r->fProto)
+      r->fPendingProto = token;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the function that materializes pending TProtoClasses.
+
+void TClassTable::SetProtoLoader(ProtoLoaderFunc_t loader)
+{
+   fgProtoLoader = loader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the loader for a pending TProtoClass, if any, and return the result.
+
+TProtoClass *TClassTable::LoadPendingProto(TClassRec *r)
+{
+   if (!r->fPendingProto || !fgProtoLoader)
+      return nullptr;
+
+   const void *token = r->fPendingProto;
+   r->fPendingProto = 0;
+   fgProtoLoader(token);
+   return r->fProto;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void TClassTable::AddAlternate(const char *normName, const char *alternate)
@@ -546,7 +595,7 @@ TProtoClass *TClassTable::GetProto(const char *cname)
    if (!CheckClassTableInit()) return nullptr;
 
    TClassRec *r = FindElement(cname);
-   if (r) return r->fProto;
+   if (r) return r->fProto ? r->fProto : LoadPendingProto(r);
    return 0;
 }
 
@@ -563,7 +612,7 @@ TProtoClass *TClassTable::GetProtoNorm(const char *cname)
    if (!CheckClassTableInit()) return nullptr;
 
    TClassRec *r = FindElementImpl(cname,kFALSE);
-   if (r) return r->fProto;
+   if (r) return r->fProto ? r->fProto : LoadPendingProto(r);
    return 0;
 }
 
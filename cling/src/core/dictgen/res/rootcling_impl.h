@@ -27,6 +27,7 @@ namespace RootCling {
       const char *(*fTROOT__GetEtcDir)() = nullptr;
       cling::Interpreter *(*fTCling__GetInterpreter)() = nullptr;
       void (*fInitializeStreamerInfoROOTFile)(const char *filename) = nullptr;
+      void (*fSetStreamerInfoROOTFileCompression)(int settings) = nullptr;
       void (*fAddStreamerInfoToROOTFile)(const char *normName) = nullptr;
       void (*fAddTypedefToROOTFile)(const char *tdname) = nullptr;
       void (*fAddEnumToROOTFile)(const char *tdname) = nullptr;
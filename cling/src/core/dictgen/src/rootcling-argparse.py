@@ -111,6 +111,10 @@ This allows the header to be inlined within the dictionary
 	parser.add_argument('-interpreteronly', help='No IO information in the dictionary\n')
 	parser.add_argument('-noIncludePaths', help="""Do not store the headers' directories in the dictionary
 Instead, rely on the environment variable $ROOT_INCLUDE_PATH at runtime
+""")
+	parser.add_argument('-compressPCM', help="""Compression settings of the pcm file, as 100*algorithm + level
+E.g. 404 for LZ4 (fastest to load) or 505 for ZSTD; 0 writes it
+uncompressed. The default is the compiled-in default setting.
 """)
 	parser.add_argument('-excludePath', help="""Specify a path to be excluded from the include paths
 specified for building this dictionary
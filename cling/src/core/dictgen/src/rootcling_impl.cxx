@@ -80,6 +80,7 @@ const char *shortHelp =
 #include "clang/Lex/ModuleMap.h"
 #include "clang/Lex/Pragma.h"
 #include "clang/Sema/Sema.h"
+#include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ASTWriter.h"
 #include "cling/Utils/AST.h"
 
@@ -95,6 +96,7 @@ const char *shortHelp =
 #include "TModuleGenerator.h"
 #include "TClassEdit.h"
 #include "TClingUtils.h"
+#include "TClingRootmapIndex.h"
 #include "RStl.h"
 #include "XMLReader.h"
 #include "LinkdefReader.h"
@@ -1983,6 +1985,19 @@ static bool WriteAST(llvm::StringRef fileName, clang::CompilerInstance *compiler
 
    compilerInstance->getFrontendOpts().RelocatablePCH = true;
 
+   // If a PCH was loaded (-include-pch), write a chained PCH on top of it, which
+   // only holds what was declared since and loads its base when used; this is
+   // how user headers are layered on the standard PCH (see makepch.py).
+   if (!module) {
+      if (clang::ASTReader *reader = compilerInstance->getASTReader().get()) {
+         bool hasPCH = false;
+         for (const clang::serialization::ModuleFile &M : reader->getModuleManager())
+            hasPCH |= M.Kind == clang::serialization::MK_PCH;
+         if (hasPCH)
+            static_cast<clang::ASTDeserializationListener&>(writer).ReaderInitialized(reader);
+      }
+   }
+
    writer.WriteAST(compilerInstance->getSema(), fileName.str(), module, iSysRoot);
 
    // Write the generated bitstream to "Out".
@@ -2208,6 +2223,7 @@ int ExtractAutoloadKeys(std::list<std::string> &names,
 /// class TButton
 /// (header1.h header2.h .. headerN.h)
 /// class TMyClass
+/// The same content is stored in binary form next to it, see TRootmapIndex.
 
 int CreateNewRootMapFile(const std::string &rootmapFileName,
                          const std::string &rootmapLibName,
@@ -2231,6 +2247,11 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
    // This is done to avoid duplications of keys with typedefs
    std::unordered_set<std::string> classesKeys;
 
+   // Content of the binary index
+   using TMetaUtils::TRootmapIndex;
+   std::vector<std::string> indexDecls;
+   std::vector<TRootmapIndex::Key> indexKeys;
+
 
    // Add the "section"
    if (!classesNames.empty() || !nsNames.empty() || !tdNames.empty() ||
@@ -2241,6 +2262,7 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
          rootmapFile << "{ decls }\n";
          for (auto & classDef : classesDefsList) {
             rootmapFile << classDef << std::endl;
+            indexDecls.push_back(classDef);
          }
          rootmapFile << "\n";
       }
@@ -2251,6 +2273,7 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
          rootmapFile << "# List of selected classes\n";
          for (auto & className : classesNames) {
             rootmapFile << "class " << className << std::endl;
+            indexKeys.push_back({TRootmapIndex::kClass, className, 0});
             classesKeys.insert(className);
          }
          // And headers
@@ -2266,6 +2289,7 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
                         headersToIgnore.find(header) == headersToIgnore.end() &&
                         TMetaUtils::IsHeaderName(header)){
                         rootmapFile << "header " << header << std::endl;
+                        indexKeys.push_back({TRootmapIndex::kHeader, header, 0});
                   }
                }
             }
@@ -2277,6 +2301,7 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
          rootmapFile << "# List of selected namespaces\n";
          for (auto & nsName : nsNames) {
             rootmapFile << "namespace " << nsName << std::endl;
+            indexKeys.push_back({TRootmapIndex::kNamespace, nsName, 0});
          }
       }
 
@@ -2284,8 +2309,10 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
       if (!tdNames.empty()) {
          rootmapFile << "# List of selected typedefs and outer classes\n";
          for (const auto & autoloadKey : tdNames)
-            if (classesKeys.insert(autoloadKey).second)
+            if (classesKeys.insert(autoloadKey).second) {
                rootmapFile << "typedef " << autoloadKey << std::endl;
+               indexKeys.push_back({TRootmapIndex::kTypedef, autoloadKey, 0});
+            }
       }
 
       // And Enums. There is no incomplete type for an enum but we can nevertheless
@@ -2293,20 +2320,33 @@ int CreateNewRootMapFile(const std::string &rootmapFileName,
       if (!enNames.empty()){
          rootmapFile << "# List of selected enums and outer classes\n";
          for (const auto & autoloadKey : enNames)
-            if (classesKeys.insert(autoloadKey).second)
+            if (classesKeys.insert(autoloadKey).second) {
                rootmapFile << "enum " << autoloadKey << std::endl;
+               indexKeys.push_back({TRootmapIndex::kEnum, autoloadKey, 0});
+            }
       }
 
       // And variables.
       if (!varNames.empty()){
          rootmapFile << "# List of selected vars\n";
          for (const auto & autoloadKey : varNames)
-            if (classesKeys.insert(autoloadKey).second)
+            if (classesKeys.insert(autoloadKey).second) {
                rootmapFile << "var " << autoloadKey << std::endl;
+               indexKeys.push_back({TRootmapIndex::kVar, autoloadKey, 0});
+            }
       }
 
    }
 
+   // The index is an optimization only: failing to write it is not an error,
+   // but a stale one must not survive.
+   rootmapFile.close();
+   const std::string indexFileName = rootmapFileName + TRootmapIndex::Extension();
+   if (!TRootmapIndex::Write(indexFileName, indexDecls, {rootmapLibName}, indexKeys)) {
+      std::remove(indexFileName.c_str());
+      ::CppyyLegacy::TMetaUtils::Warning(0, "Could not write rootmap index %s\n", indexFileName.c_str());
+   }
+
    return 0;
 
 }
@@ -3859,6 +3899,11 @@ gOptWriteEmptyRootPCM("writeEmptyRootPCM",
                      llvm::cl::Hidden,
                      llvm::cl::desc("Does not include the header files as it assumes they exist in the pch."),
                      llvm::cl::cat(gRootclingOptions));
+static llvm::cl::opt<int>
+gOptCompressPCM("compressPCM",
+               llvm::cl::desc("Compression settings (100*algorithm + level, e.g. 404 for LZ4) of the rdict PCM; 0 for none."),
+               llvm::cl::init(-1),
+               llvm::cl::cat(gRootclingOptions));
 static llvm::cl::opt<bool>
 gOptCheckSelectionSyntax("selSyntaxOnly",
                         llvm::cl::desc("Check the selection syntax only."),
@@ -4920,6 +4965,9 @@ int RootClingMain(int argc,
       if (gDriverConfig->fInitializeStreamerInfoROOTFile) {
          gDriverConfig->fInitializeStreamerInfoROOTFile(modGen.GetModuleFileName().c_str());
       }
+      if (gOptCompressPCM >= 0 && gDriverConfig->fSetStreamerInfoROOTFileCompression) {
+         gDriverConfig->fSetStreamerInfoROOTFileCompression(gOptCompressPCM);
+      }
 
       // The order of addition to the list of constructor type
       // is significant.  The list is sorted by with the highest
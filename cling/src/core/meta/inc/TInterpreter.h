@@ -44,10 +44,19 @@ class TListOfEnums;
 
 R__EXTERN TVirtualMutex *gInterpreterMutex;
 
+// Interpreter locking: anything that may modify the AST (lookups, template
+// instantiation, deserialization from PCMs, record layout, code generation)
+// takes the exclusive lock with R__LOCKGUARD(gInterpreterMutex), or with
+// R__LOCKGUARD_CLING if it may run user code. Queries that are answered from
+// results memoized under the exclusive lock, use R__READ_LOCKGUARD_CLING,
+// which allows concurrent readers when the interpreter mutex is the
+// read-write gCoreMutex (i.e. after TThread::Initialize()).
 #if defined (_REENTRANT) || defined (WIN32)
 # define R__LOCKGUARD_CLING(mutex)  ::CppyyLegacy::Internal::InterpreterMutexRegistrationRAII _R__UNIQUE_(R__guard)(mutex); { }
+# define R__READ_LOCKGUARD_CLING(mutex)  ::CppyyLegacy::Internal::InterpreterReadLockRAII _R__UNIQUE_(R__readguard)(mutex)
 #else
 # define R__LOCKGUARD_CLING(mutex)  (void)(mutex); { }
+# define R__READ_LOCKGUARD_CLING(mutex)  (void)(mutex)
 #endif
 
 namespace Internal {
@@ -56,6 +65,17 @@ struct InterpreterMutexRegistrationRAII {
    InterpreterMutexRegistrationRAII(TVirtualMutex* mutex);
    ~InterpreterMutexRegistrationRAII();
 };
+
+// Shared lock on the interpreter mutex; exclusive if it is not read-write.
+struct InterpreterReadLockRAII {
+   TVirtualMutex *fMutex;
+   TVirtualRWMutex *fRWMutex;
+   TVirtualRWMutex::Hint_t *fHint;
+   InterpreterReadLockRAII(TVirtualMutex* mutex);
+   ~InterpreterReadLockRAII();
+   InterpreterReadLockRAII(const InterpreterReadLockRAII&) = delete;
+   InterpreterReadLockRAII& operator=(const InterpreterReadLockRAII&) = delete;
+};
 } // namespace Internal
 
 class TInterpreter : public TNamed {
@@ -92,13 +112,13 @@ public:
       typedef void (*Dtor_t)(void*, unsigned long, int);
 
       CallFuncIFacePtr_t():
-         fKind(kUninitialized), fGeneric(0), fDirect(0) {}
+         fKind(kUninitialized), fGeneric(0), fDirect(0), fArgs(0) {}
       CallFuncIFacePtr_t(Generic_t func, bool as_iface) :
-         fKind(kGeneric), fGeneric(as_iface ? func : 0), fDirect(as_iface ? 0 : func) {}
+         fKind(kGeneric), fGeneric(as_iface ? func : 0), fDirect(as_iface ? 0 : func), fArgs(0) {}
       CallFuncIFacePtr_t(Ctor_t func):
-         fKind(kCtor), fCtor(func), fDirect(0) {}
+         fKind(kCtor), fCtor(func), fDirect(0), fArgs(0) {}
       CallFuncIFacePtr_t(Dtor_t func):
-         fKind(kDtor), fDtor(func), fDirect(0) {}
+         fKind(kDtor), fDtor(func), fDirect(0), fArgs(0) {}
 
       EKind fKind;
       union {
@@ -107,8 +127,15 @@ public:
          Dtor_t fDtor;
       };
       Generic_t fDirect;
+      Generic_t fArgs;   // as fGeneric/fDirect, but taking the args in the layout set by CallFunc_SetArgLayout
    };
 
+   // Calls a wrapper over n sets of arguments, taken from strided columns
+   // (one per argument), with results written to a strided output buffer.
+   typedef void (*CallFuncBatch_t)(void** /* selves */, int /* nargs */, void** /* columns */,
+                                   const size_t* /* strides */, size_t /* n */,
+                                   void* /* out */, size_t /* out_stride */);
+
    class SuspendAutoParsing {
       TInterpreter *fInterp;
       Bool_t        fPrevious;
@@ -264,6 +291,11 @@ public:
    // core/meta helper functions.
    virtual EReturnType MethodCallReturnType(TFunction *func) const = 0;
    virtual ULong64_t GetInterpreterStateMarker() const = 0;
+   // Names declared in namespace scope (fully qualified, second empty) or added
+   // from rootmap files (key, library) since the previous call; returns kFALSE if
+   // these are incomplete (first call, or unloaded declarations) and any index
+   // built from them needs to be rebuilt.
+   virtual Bool_t TakeNewDeclaredNames(std::vector<std::pair<std::string, std::string>> &names) { names.clear(); return kFALSE; }
    virtual bool DiagnoseIfInterpreterException(const std::exception &e) const = 0;
 
    typedef TDictionary::DeclId_t DeclId_t;
@@ -298,9 +330,15 @@ public:
    virtual MethodInfo_t *CallFunc_FactoryMethod(CallFunc_t* /* func */) const {return 0;}
    virtual void   CallFunc_Init(CallFunc_t* /* func */) const {;}
    virtual Bool_t CallFunc_IsValid(CallFunc_t* /* func */) const {return 0;}
+   virtual Bool_t CallFunc_IsNoexcept(CallFunc_t* /* func */) const {return 0;}
    virtual CallFuncIFacePtr_t CallFunc_IFacePtr(CallFunc_t* /* func */, bool /* as_iface */) const {return CallFuncIFacePtr_t();}
+   virtual CallFuncBatch_t CallFunc_BatchIFacePtr(CallFunc_t* /* func */, bool /* as_iface */) const {return nullptr;}
+   virtual void   CallFunc_IFacePtrs(const std::vector<CallFunc_t*>& funcs, bool as_iface, std::vector<CallFuncIFacePtr_t>& res) const {
+      for (auto f : funcs) res.push_back(CallFunc_IFacePtr(f, as_iface));
+   }
 
    virtual void   CallFunc_SetFunc(CallFunc_t* /* func */, MethodInfo_t * /* info */) const {;}
+   virtual void   CallFunc_SetArgLayout(size_t /* stride */, size_t /* value_offset */, size_t /* ref_offset */, size_t /* type_offset */) const {;}
 
    virtual std::string CallFunc_GetWrapperCode(CallFunc_t* func, bool as_iface) const = 0;
 
@@ -511,6 +549,25 @@ inline CppyyLegacy::Internal::InterpreterMutexRegistrationRAII::~InterpreterMute
       ::gCling->ForgetMutexState();
 }
 
+inline CppyyLegacy::Internal::InterpreterReadLockRAII::InterpreterReadLockRAII(TVirtualMutex* mutex):
+   fMutex(mutex), fRWMutex(nullptr), fHint(nullptr)
+{
+   if (!fMutex)
+      return;
+   if (fMutex == gCoreMutex) {
+      fRWMutex = gCoreMutex;
+      fHint = fRWMutex->ReadLock();
+   } else
+      fMutex->Lock();
+}
+inline CppyyLegacy::Internal::InterpreterReadLockRAII::~InterpreterReadLockRAII()
+{
+   if (fRWMutex)
+      fRWMutex->ReadUnLock(fHint);
+   else if (fMutex)
+      fMutex->UnLock();
+}
+
 } // namespace CppyyLegacy
 
 #endif
@@ -54,6 +54,7 @@ In order to access the name of a class within the ROOT type system, the method T
 #include "TExMap.h"
 #include "TFunctionTemplate.h"
 #include "THashList.h"
+#include "TInstrumentation.h"
 #include "TInterpreter.h"
 #include "TMemberInspector.h"
 #include "TMethod.h"
@@ -2104,6 +2105,8 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
 
    if (!gROOT->GetListOfClasses()) return 0;
 
+   TInstrumentation::TTimer timer(TInstrumentation::kGetClass, name);
+
    // FindObject will take the read lock before actually getting the
    // TClass pointer so we will need not get a partially initialized
    // object.
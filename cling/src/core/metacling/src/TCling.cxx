@@ -31,6 +31,7 @@ clang/LLVM technology.
 #include "TClingTypedefInfo.h"
 #include "TClingTypeInfo.h"
 #include "TClingValue.h"
+#include "TClingRootmapIndex.h"
 
 #include "TROOT.h"
 #include "TApplication.h"
@@ -57,6 +58,7 @@ clang/LLVM technology.
 #include "TEnum.h"
 #include "TEnumConstant.h"
 #include "THashTable.h"
+#include "TInstrumentation.h"
 #include "RConfigure.h"
 #include "compiledata.h"
 #include "TClingUtils.h"
@@ -144,7 +146,10 @@ clang/LLVM technology.
 #ifndef R__WIN32
 #include <cxxabi.h>
 #define R__DLLEXPORT __attribute__ ((visibility ("default")))
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #endif
 #include <limits.h>
 #include <stdio.h>
@@ -505,6 +510,9 @@ void TCling::HandleNewDecl(const void* DV, bool isDeserialized, std::set<TClass*
 
    const clang::Decl* D = static_cast<const clang::Decl*>(DV);
 
+   if (fNewDeclaredNamesValid)
+      RecordDeclaredName(D, isDeserialized);
+
    if (!D->isCanonicalDecl() && !isa<clang::NamespaceDecl>(D)
        && !dyn_cast<clang::RecordDecl>(D)) return;
 
@@ -559,6 +567,115 @@ void TCling::HandleNewDecl(const void* DV, bool isDeserialized, std::set<TClass*
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record the name of a new declaration in namespace (or global) scope, for
+/// the incremental name indices of the bindings (see TakeNewDeclaredNames()).
+/// Deserialized namespaces are not descended into, as their members will be
+/// reported on their own when (and if) these get deserialized.
+
+void TCling::RecordDeclaredName(const clang::Decl *D, bool isDeserialized)
+{
+   // a large backlog is dropped: it is cheaper for the consumer to rebuild
+   const size_t kMaxNewDeclaredNames = 1 << 18;
+
+   if (!isDeserialized && (isa<NamespaceDecl>(D) || isa<LinkageSpecDecl>(D))) {
+      for (const Decl *member : cast<DeclContext>(D)->decls())
+         RecordDeclaredName(member, isDeserialized);
+   }
+
+   const NamedDecl *ND = dyn_cast<NamedDecl>(D);
+   if (!ND || !ND->getDeclContext()->getRedeclContext()->isFileContext())
+      return;
+
+   // The enumerators of unscoped enums (also anonymous ones) are listed as
+   // members of the enclosing scope, as in a full rebuild of the names.
+   if (const EnumDecl *ED = dyn_cast<EnumDecl>(ND)) {
+      if (!ED->isScoped() && ED->isThisDeclarationADefinition()) {
+         for (const EnumConstantDecl *ECD : ED->enumerators())
+            RecordDeclaredName(ECD, isDeserialized);
+      }
+   }
+
+   if (!ND->getDeclName().isIdentifier() || ND->getName().empty())
+      return;
+
+   if (const CXXRecordDecl *RD = dyn_cast<CXXRecordDecl>(ND)) {
+      if (RD->getDescribedClassTemplate())
+         return;     // reported through the ClassTemplateDecl
+   } else if (const FunctionDecl *FD = dyn_cast<FunctionDecl>(ND)) {
+      if (FD->getDescribedFunctionTemplate())
+         return;     // id. FunctionTemplateDecl
+   } else if (!isa<TagDecl>(ND) && !isa<TypedefNameDecl>(ND) && !isa<TemplateDecl>(ND) &&
+              !isa<VarDecl>(ND) && !isa<NamespaceDecl>(ND) && !isa<EnumConstantDecl>(ND))
+      return;
+
+   if (fNewDeclaredNames.size() >= kMaxNewDeclaredNames) {
+      InvalidateDeclaredNames();
+      return;
+   }
+
+   // Enumerators are qualified by the scope of their enum, not by the enum.
+   const NamedDecl *scoped = ND;
+   if (isa<EnumConstantDecl>(ND))
+      scoped = dyn_cast<NamedDecl>(ND->getDeclContext()->getRedeclContext());
+
+   std::string name;
+   llvm::raw_string_ostream stream(name);
+   if (scoped == ND)
+      ND->getNameForDiagnostic(stream, ND->getASTContext().getPrintingPolicy(), /*Qualified=*/true);
+   else {
+      if (scoped)
+         scoped->getNameForDiagnostic(stream, ND->getASTContext().getPrintingPolicy(), /*Qualified=*/true);
+      stream << (scoped ? "::" : "") << ND->getName();
+   }
+   fNewDeclaredNames.emplace_back(std::move(stream.str()), std::string{});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the rootmap entries from index `first` on (entries are appended).
+
+void TCling::RecordRootmapEntries(Int_t first)
+{
+   if (!fNewDeclaredNamesValid || !fMapfile || !fMapfile->GetTable())
+      return;
+
+   Int_t ientry = 0;
+   TIter next(fMapfile->GetTable());
+   while (TEnvRec *rec = (TEnvRec*)next()) {
+      if (ientry++ < first)
+         continue;
+      const char *lib = rec->GetValue();
+      if (lib && *lib)
+         fNewDeclaredNames.emplace_back(rec->GetName(), lib);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stop recording new names (e.g. after unloading), until the next call to
+/// TakeNewDeclaredNames() restarts it.
+
+void TCling::InvalidateDeclaredNames()
+{
+   fNewDeclaredNamesValid = kFALSE;
+   fNewDeclaredNames.clear();
+   fNewDeclaredNames.shrink_to_fit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hand over the names recorded since the previous call, see
+/// TInterpreter::TakeNewDeclaredNames(). Recording starts with the first call.
+
+Bool_t TCling::TakeNewDeclaredNames(std::vector<std::pair<std::string, std::string>> &names)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+
+   names.clear();
+   names.swap(fNewDeclaredNames);
+   Bool_t valid = fNewDeclaredNamesValid;
+   fNewDeclaredNamesValid = kTRUE;
+   return valid;
+}
+
 extern "C"
 void TCling__GetNormalizedContext(const CppyyLegacy::TMetaUtils::TNormalizedCtxt*& normCtxt)
 {
@@ -1443,6 +1560,24 @@ TCling::TCling(const char *name, const char *title, const char* const argv[], vo
             pchFilename = gSystem->Getenv("CLING_STANDARD_PCH");
          }
 
+         // A user PCH is chained on top of the standard one, which it loads
+         // by itself (only a single -include-pch is allowed). It is only
+         // accepted with the flags that it was built with.
+         if (const char *userPCH = gSystem->Getenv("CLING_USER_PCH")) {
+            if (FileExists(userPCH)) {
+               pchFilename = userPCH;
+               if (const char *userFlags = gSystem->Getenv("CLING_USER_PCH_FLAGS")) {
+                  StringRef Flags(userFlags);
+                  while (!Flags.empty()) {
+                     StringRef Flag;
+                     std::tie(Flag, Flags) = Flags.split(' ');
+                     if (!Flag.empty())
+                        clingArgsStorage.push_back(Flag.str());
+                  }
+               }
+            }
+         }
+
          if (FileExists(pchFilename.c_str())) {
             clingArgsStorage.push_back("-include-pch");
             clingArgsStorage.push_back(pchFilename);
@@ -1526,6 +1661,10 @@ TCling::TCling(const char *name, const char *title, const char* const argv[], vo
       }
    }
 
+   // Proto classes from rdict PCMs are deserialized on demand.
+   if (!fromRootCling && !gSystem->Getenv("CPPYY_EAGER_PCM"))
+      TClassTable::SetProtoLoader(&TCling::LoadPendingProtoClasses);
+
    std::vector<const char*> interpArgs;
    for (std::vector<std::string>::const_iterator iArg = clingArgsStorage.begin(),
            eArg = clingArgsStorage.end(); iArg != eArg; ++iArg)
@@ -1663,6 +1802,44 @@ TCling::TCling(const char *name, const char *title, const char* const argv[], vo
 }
 
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Map a PCM file read-only into memory; returns nullptr if not possible, in
+/// which case the caller should fall back to reading it.
+
+const char *MapPCMFile(const std::string &fileName, size_t &size)
+{
+#ifndef R__WIN32
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+      return nullptr;
+   struct stat st;
+   void *addr = MAP_FAILED;
+   if (::fstat(fd, &st) == 0 && 0 < st.st_size) {
+      size = (size_t)st.st_size;
+      addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   }
+   ::close(fd);        // the mapping keeps its own reference
+   return addr == MAP_FAILED ? nullptr : (const char *)addr;
+#else
+   (void)fileName; (void)size;
+   return nullptr;
+#endif
+}
+
+void UnmapPCMFile(const char *data, size_t size)
+{
+#ifndef R__WIN32
+   if (data)
+      ::munmap(const_cast<char *>(data), size);
+#else
+   (void)data; (void)size;
+#endif
+}
+
+} // unnamed namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Destroy the interpreter interface.
 
@@ -1678,6 +1855,11 @@ TCling::~TCling()
    delete fTemporaries;
    delete fNormalizedCtxt;
    delete fLookupHelper;
+   TClassTable::SetProtoLoader(nullptr);
+   for (auto &pending : fPendingProtoClasses) {
+      if (pending.fMapped)
+         UnmapPCMFile(pending.fData, pending.fSize);
+   }
    gCling = 0;
 }
 
@@ -1795,8 +1977,11 @@ void TCling::RegisterRdictForLoadPCM(const std::string &pcmFileNameFullPath, llv
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Tries to load a PCM from TFile; returns true on success.
+/// If pending is given (i.e. the PCM content outlives this call) and the PCM
+/// lists the names of its proto classes, these are only registered with
+/// TClassTable, to be deserialized on first use.
 
-void TCling::LoadPCMImpl(TFile &pcmFile)
+void TCling::LoadPCMImpl(TFile &pcmFile, TPendingProtoClasses *pending)
 {
    auto listOfKeys = pcmFile.GetListOfKeys();
 
@@ -1812,7 +1997,32 @@ void TCling::LoadPCMImpl(TFile &pcmFile)
    if (gDebug > 1)
       ::CppyyLegacy::Info("TCling::LoadPCMImpl", "reading protoclasses for %s \n", pcmFile.GetName());
 
-   pcmFile.GetObject("__ProtoClasses", protoClasses);
+   TObjArray *protoClassNames = nullptr;
+   if (pending)
+      pcmFile.GetObject("__ProtoClassNames", protoClassNames);
+
+   if (protoClassNames) {
+      protoClassNames->SetOwner(kTRUE);
+      // Existing TClasses need to be updated right away, requiring eager loading.
+      bool deferred = true;
+      for (auto name : *protoClassNames) {
+         TClass *existingCl = (TClass *)gROOT->GetListOfClasses()->FindObject(name->GetName());
+         if (existingCl && existingCl->GetState() != TClass::kHasTClassInit) {
+            deferred = false;
+            break;
+         }
+      }
+      if (deferred) {
+         for (auto name : *protoClassNames)
+            TClassTable::AddPendingProto(name->GetName(), pending);
+         pending->fDeferred = true;
+      }
+      delete protoClassNames;
+   }
+
+   protoClasses = nullptr;
+   if (!pending || !pending->fDeferred)
+      pcmFile.GetObject("__ProtoClasses", protoClasses);
 
    if (protoClasses) {
       for (auto obj : *protoClasses) {
@@ -1912,6 +2122,7 @@ void TCling::LoadPCMImpl(TFile &pcmFile)
 
 void TCling::LoadPCM(std::string pcmFileNameFullPath)
 {
+   TInstrumentation::TTimer timer(TInstrumentation::kLoadPCM, pcmFileNameFullPath.c_str());
    SuspendAutoloadingRAII autoloadOff(this);
    SuspendAutoParsing autoparseOff(this);
    assert(!pcmFileNameFullPath.empty());
@@ -1940,11 +2151,12 @@ void TCling::LoadPCM(std::string pcmFileNameFullPath)
    auto pendingRdict = fPendingRdicts.find(pcmFileNameFullPath);
    if (pendingRdict != fPendingRdicts.end()) {
       llvm::StringRef pcmContent = pendingRdict->second;
-      TMemFile::ZeroCopyView_t range{pcmContent.data(), pcmContent.size()};
-      std::string RDictFileOpts = pcmFileNameFullPath + "?filetype=pcm";
-      TMemFile pcmMemFile(RDictFileOpts.c_str(), range);
-
-      LoadPCMImpl(pcmMemFile);
+      fPendingProtoClasses.emplace_back();
+      TPendingProtoClasses &pending = fPendingProtoClasses.back();
+      pending.fFileName = pcmFileNameFullPath;
+      pending.fData = pcmContent.data();
+      pending.fSize = pcmContent.size();
+      LoadPCMContent(pending);
 
       fPendingRdicts.erase(pendingRdict);
 
@@ -1965,10 +2177,95 @@ void TCling::LoadPCM(std::string pcmFileNameFullPath)
       Fatal("LoadPCM", "The file %s is not a ROOT as was expected\n", pcmFileName.Data());
       return;
    }
+
+   // Map the file rather than reading it, so that TMemFile works off the
+   // page cache without copies.
+   size_t pcmSize = 0;
+   if (const char *pcmData = MapPCMFile(pcmFileNameFullPath, pcmSize)) {
+      fPendingProtoClasses.emplace_back();
+      TPendingProtoClasses &pending = fPendingProtoClasses.back();
+      pending.fFileName = pcmFileNameFullPath;
+      pending.fData = pcmData;
+      pending.fSize = pcmSize;
+      pending.fMapped = true;
+      LoadPCMContent(pending);
+      return;
+   }
+
    TFile pcmFile(pcmFileName + "?filetype=pcm", "READ");
    LoadPCMImpl(pcmFile);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Load a PCM from memory; its proto classes are deserialized on demand if
+/// possible (from a copy if the memory belongs to a library), otherwise the
+/// memory is released.
+
+void TCling::LoadPCMContent(TPendingProtoClasses &pending)
+{
+   {
+      TMemFile::ZeroCopyView_t range{pending.fData, pending.fSize};
+      std::string RDictFileOpts = pending.fFileName + "?filetype=pcm";
+      TMemFile pcmMemFile(RDictFileOpts.c_str(), range);
+
+      LoadPCMImpl(pcmMemFile, TClassTable::HasProtoLoader() ? &pending : nullptr);
+   }
+
+   if (!pending.fDeferred) {
+      if (pending.fMapped)
+         UnmapPCMFile(pending.fData, pending.fSize);
+      fPendingProtoClasses.remove_if([&pending](const TPendingProtoClasses &p) { return &p == &pending; });
+   } else if (!pending.fMapped) {
+      // The content lives in the dictionary library, which may be unloaded
+      // before the proto classes are used: keep a copy instead.
+      pending.fCopy.assign(pending.fData, pending.fSize);
+      pending.fData = pending.fCopy.data();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Deserialize the proto classes of a PCM that were registered as pending
+/// with TClassTable; called by TClassTable on first use.
+
+void TCling::LoadPendingProtoClasses(const void *token)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+   TCling *cling = (TCling *)gCling;
+   TPendingProtoClasses &pending = *(TPendingProtoClasses *)const_cast<void *>(token);
+   if (!cling || !pending.fData)
+      return;
+
+   TInstrumentation::TTimer timer(TInstrumentation::kLoadPCM, pending.fFileName.c_str());
+
+   SuspendAutoloadingRAII autoloadOff(cling);
+   SuspendAutoParsing autoparseOff(cling);
+   TDirectory::TContext ctxt;
+   llvm::SaveAndRestore<Int_t> SaveGDebug(gDebug);
+   gDebug = 0;
+
+   {
+      TMemFile::ZeroCopyView_t range{pending.fData, pending.fSize};
+      std::string RDictFileOpts = pending.fFileName + "?filetype=pcm";
+      TMemFile pcmMemFile(RDictFileOpts.c_str(), range);
+
+      TObjArray *protoClasses = nullptr;
+      pcmMemFile.GetObject("__ProtoClasses", protoClasses);
+      if (protoClasses) {
+         for (auto obj : *protoClasses)
+            TClassTable::Add((TProtoClass *)obj);
+         protoClasses->Clear(); // Ownership was transfered to TClassTable.
+         delete protoClasses;
+      }
+   }
+
+   if (pending.fMapped)
+      UnmapPCMFile(pending.fData, pending.fSize);
+   pending.fData = nullptr;
+   pending.fSize = 0;
+   pending.fMapped = false;
+   std::string().swap(pending.fCopy);
+}
+
 //______________________________________________________________________________
 
 namespace {
@@ -2518,6 +2815,7 @@ intptr_t TCling::ProcessLine(const char* line, int* error_/*=0*/)
    // were doing.
    //
    EErrorCode* error = (EErrorCode*)error_;
+   TInstrumentation::TTimer timer(TInstrumentation::kProcessLine, line);
 
    TString sLine(line);
 
@@ -3121,6 +3419,7 @@ void TCling::ClearStack()
 bool TCling::Declare(const char* code, bool silent)
 {
    R__LOCKGUARD_CLING(gInterpreterMutex);
+   TInstrumentation::TTimer timer(TInstrumentation::kDeclare);
 
    SuspendAutoloadingRAII autoLoadOff(this);
    SuspendAutoParsing autoParseRaii(this);
@@ -4982,6 +5281,19 @@ static bool requiresRootMap(const char* rootmapfile, cling::Interpreter* interp)
    return !gInterpreter->HasPCMForLibrary(libName.str().c_str());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the library list of a rootmap section without surrounding spaces;
+/// rootcling writes "[ lib ]", the index stores "lib". Both the text and the
+/// index are read through this, so that they give the same library map.
+
+static std::string TrimRootmapLibName(const std::string &lib_name)
+{
+   const size_t begin = lib_name.find_first_not_of(' ');
+   if (begin == std::string::npos)
+      return std::string();
+   return lib_name.substr(begin, lib_name.find_last_not_of(' ') - begin + 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read and parse a rootmapfile in its new format, and return 0 in case of
 /// success, -1 if the file has already been read, and -3 in case its format
@@ -5010,6 +5322,17 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
    if (uniqueString)
       uniqueString->Append(std::string("\n#line 1 \"Forward declarations from ") + rootmapfileNoBackslash + "\"\n");
 
+   // Use the binary index written by rootcling, if not older than the rootmap.
+   const std::string indexfile = rootmapfileNoBackslash + TMetaUtils::TRootmapIndex::Extension();
+   FileStat_t rootmapStat, indexStat;
+   if (gSystem->GetPathInfo(indexfile.c_str(), indexStat) == 0 &&
+       gSystem->GetPathInfo(rootmapfileNoBackslash.c_str(), rootmapStat) == 0 &&
+       rootmapStat.fMtime <= indexStat.fMtime) {
+      TMetaUtils::TRootmapIndex index;
+      if (index.Open(indexfile))
+         return ReadRootmapIndex(index, rootmapfileNoBackslash, uniqueString);
+   }
+
    std::ifstream file(rootmapfileNoBackslash);
    std::string line;
    line.reserve(200);
@@ -5043,12 +5366,7 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
          auto brpos = line.find(']');
          if (brpos == string::npos)
             continue;
-         lib_name = line.substr(1, brpos - 1);
-         size_t nspaces = 0;
-         while (lib_name[nspaces] == ' ')
-            ++nspaces;
-         if (nspaces)
-            lib_name.replace(0, nspaces, "");
+         lib_name = TrimRootmapLibName(line.substr(1, brpos - 1));
          if (gDebug > 3) {
             TString lib_nameTstr(lib_name.c_str());
             TObjArray *tokens = lib_nameTstr.Tokenize(" ");
@@ -5099,6 +5417,62 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the library map from the binary index of a rootmap file, with the same
+/// results as reading the text; return codes as for ReadRootmapFile.
+
+int TCling::ReadRootmapIndex(const TMetaUtils::TRootmapIndex &index, const std::string &rootmapfile,
+                             TUniqueString *uniqueString)
+{
+   if (index.GetNumDecls()) {
+      if (!uniqueString) {
+         Error("ReadRootmapFile", "Cannot handle \"{ decls }\" sections in custom rootmap file %s",
+               rootmapfile.c_str());
+         return -4;
+      }
+      for (uint32_t idecl = 0; idecl < index.GetNumDecls(); ++idecl)
+         uniqueString->Append(index.GetDecl(idecl));
+   }
+
+   std::vector<std::string> libs;
+   libs.reserve(index.GetNumLibs());
+   for (uint32_t ilib = 0; ilib < index.GetNumLibs(); ++ilib)
+      libs.push_back(TrimRootmapLibName(index.GetLib(ilib)));
+
+   std::string keyname;
+   for (uint32_t ikey = 0; ikey < index.GetNumKeys(); ++ikey) {
+      uint32_t keyLen = 0;
+      const char *key = index.GetKeyName(ikey, keyLen);
+      keyname.assign(key, keyLen);
+      const char kind = index.GetKeyKind(ikey);
+      const std::string &lib_name = libs[index.GetKeyLib(ikey)];
+      if (gDebug > 6)
+         Info("ReadRootmapFile", "class %s in %s", keyname.c_str(), lib_name.c_str());
+      TEnvRec *isThere = fMapfile->Lookup(keyname.c_str());
+      if (isThere) {
+         if (lib_name != isThere->GetValue()) { // the same key for two different libs
+            if (kind == TMetaUtils::TRootmapIndex::kNamespace) {
+               if (gDebug > 3)
+                  Info("ReadRootmapFile", "namespace %s found in %s is already in %s", keyname.c_str(),
+                       lib_name.c_str(), isThere->GetValue());
+            } else if (kind == TMetaUtils::TRootmapIndex::kHeader) {
+               // it is a header: add the libname to the list of libs to be loaded.
+               std::string libs_name = lib_name + " " + isThere->GetValue();
+               fMapfile->SetValue(keyname.c_str(), libs_name.c_str());
+            } else if (!TClassEdit::IsSTLCont(keyname)) {
+               Warning("ReadRootmapFile", "key %s found in %s is already in %s",
+                       keyname.c_str(), lib_name.c_str(), isThere->GetValue());
+            }
+         } else if (gDebug > 3) {
+            Info("ReadRootmapFile", "Key %s was already defined for %s", keyname.c_str(), lib_name.c_str());
+         }
+      } else {
+         fMapfile->SetValue(keyname.c_str(), lib_name.c_str());
+      }
+   }
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create a resource table and read the (possibly) three resource files, i.e
 /// $ROOTSYS/etc/system<name> (or ROOTETCDIR/system<name>), $HOME/<name> and
@@ -5195,6 +5569,7 @@ Int_t TCling::LoadLibraryMap(const char* rootmapfile)
       fRootmapFiles->SetOwner();
       InitRootmapFile(".rootmap");
    }
+   const Int_t firstNewEntry = fMapfile->GetTable() ? fMapfile->GetTable()->GetEntries() : 0;
 
    // Prepare a list of all forward declarations for cling
    // For some experiments it is easily as big as 500k characters. To be on the
@@ -5285,6 +5660,8 @@ Int_t TCling::LoadLibraryMap(const char* rootmapfile)
          fMapfile->IgnoreDuplicates(ignore);
       }
    }
+   RecordRootmapEntries(firstNewEntry);
+
    TEnvRec* rec;
    TIter next(fMapfile->GetTable());
    while ((rec = (TEnvRec*) next())) {
@@ -5465,6 +5842,7 @@ Int_t TCling::UnloadLibraryMap(const char* library)
    TEnvRec *rec;
    TIter next(fMapfile->GetTable());
    R__LOCKGUARD(gInterpreterMutex);
+   InvalidateDeclaredNames();
    Int_t ret = 0;
    while ((rec = (TEnvRec *) next())) {
       TString cls = rec->GetName();
@@ -5608,6 +5986,7 @@ Int_t TCling::AutoLoad(const char *cls, Bool_t knowDictNotLoaded /* = kFALSE */)
    assert(IsClassAutoloadingEnabled() && "Calling when autoloading is off!");
 
    R__LOCKGUARD(gInterpreterMutex);
+   TInstrumentation::TTimer timer(TInstrumentation::kAutoLoad, cls);
 
    if (!knowDictNotLoaded && gClassTable->GetDictNorm(cls)) {
       // The library is already loaded as the class's dictionary is known.
@@ -5862,6 +6241,8 @@ Int_t TCling::AutoParse(const char *cls)
    if (llvm::StringRef(cls).contains("(lambda)"))
       return 0;
 
+   TInstrumentation::TTimer timer(TInstrumentation::kAutoParse, cls);
+
    if (!fHeaderParsingOnDemand || fIsAutoParsingSuspended) {
       if (fClingCallbacks->IsAutoLoadingEnabled()) {
          return AutoLoad(cls);
@@ -6178,6 +6559,8 @@ void TCling::UpdateListsOnCommitted(const cling::Transaction &T) {
 void TCling::UpdateListsOnUnloaded(const cling::Transaction &T)
 {
    HandleNewTransaction(T);
+   fIsEnumCache.clear();
+   InvalidateDeclaredNames();
 
    auto Lists = std::make_tuple((TListOfDataMembers *)gROOT->GetListOfGlobals(),
                                 (TListOfFunctions *)gROOT->GetListOfGlobalFunctions(),
@@ -6278,6 +6661,9 @@ void TCling::InvalidateCachedDecl(const std::tuple<TListOfDataMembers*,
 // we need to make sure the next request for the same autoparse will be
 // honored.
 void TCling::TransactionRollback(const cling::Transaction &T) {
+   fIsEnumCache.clear();
+   InvalidateDeclaredNames();
+
    auto const &triter = fTransactionHeadersMap.find(&T);
    if (triter != fTransactionHeadersMap.end()) {
       std::size_t normNameHash = triter->second;
@@ -7062,6 +7448,16 @@ bool TCling::CallFunc_IsValid(CallFunc_t* func) const
    return f->IsValid();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the function, including the copies of its by-value
+/// arguments, can be proven not to throw.
+
+bool TCling::CallFunc_IsNoexcept(CallFunc_t* func) const
+{
+   TClingCallFunc* f = (TClingCallFunc*) func;
+   return f->IsNoexcept();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 TInterpreter::CallFuncIFacePtr_t
@@ -7071,6 +7467,34 @@ TCling::CallFunc_IFacePtr(CallFunc_t* func, bool as_iface) const
    return f->IFacePtr(as_iface);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the wrapper that calls the function in a loop over columns of arguments.
+
+TInterpreter::CallFuncBatch_t
+TCling::CallFunc_BatchIFacePtr(CallFunc_t* func, bool as_iface) const
+{
+   TClingCallFunc* f = (TClingCallFunc*) func;
+   return f->BatchIFacePtr(as_iface);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the interface pointers for all given functions, compiling all
+/// wrappers that are not yet available in a single transaction.
+
+void TCling::CallFunc_IFacePtrs(const std::vector<CallFunc_t*>& funcs, bool as_iface,
+                                std::vector<CallFuncIFacePtr_t>& res) const
+{
+   std::vector<TClingCallFunc*> cfs;
+   cfs.reserve(funcs.size());
+   for (auto func : funcs)
+      cfs.push_back((TClingCallFunc*) func);
+   TClingCallFunc::MakeWrappers(cfs, as_iface);
+
+   res.reserve(res.size() + cfs.size());
+   for (auto f : cfs)
+      res.push_back(f ? f->IFacePtr(as_iface) : CallFuncIFacePtr_t());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void TCling::CallFunc_SetFunc(CallFunc_t* func, MethodInfo_t* info) const
@@ -7080,6 +7504,14 @@ void TCling::CallFunc_SetFunc(CallFunc_t* func, MethodInfo_t* info) const
    f->SetFunc(minfo);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the layout of argument arrays, for wrappers that take these directly.
+
+void TCling::CallFunc_SetArgLayout(size_t stride, size_t value_offset, size_t ref_offset, size_t type_offset) const
+{
+   TClingCallFunc::SetArgLayout(stride, value_offset, ref_offset, type_offset);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string TCling::CallFunc_GetWrapperCode(CallFunc_t* func, bool as_iface) const
@@ -7263,7 +7695,22 @@ bool TCling::ClassInfo_IsBase(ClassInfo_t* cinfo, const char* name) const
 
 bool TCling::ClassInfo_IsEnum(const char* name) const
 {
-   return TClingClassInfo::IsEnum(GetInterpreterImpl(), name);
+   // The lookup by name modifies the AST, but its result can be shared (and
+   // is kept until declarations are unloaded).
+   {
+      R__READ_LOCKGUARD_CLING(gInterpreterMutex);
+      auto iter = fIsEnumCache.find(name);
+      if (iter != fIsEnumCache.end())
+         return iter->second;
+   }
+
+   R__LOCKGUARD(gInterpreterMutex);
+   TClingClassInfo info(GetInterpreterImpl(), name);
+   if (!info.IsValid())
+      return false;
+   bool isEnum = info.Property() & kIsEnum;
+   fIsEnumCache[name] = isEnum;
+   return isEnum;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 
 #include "TInterpreter.h"
 
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -80,6 +81,7 @@ namespace CppyyLegacy {
 
    namespace TMetaUtils {
       class TNormalizedCtxt;
+      class TRootmapIndex;
       class TClingLookupHelper;
    }
 }
@@ -123,6 +125,9 @@ private: // Data Members
    std::map<size_t,std::vector<const char*>> fClassesHeadersMap; // Map of classes hashes and headers associated
    std::map<const cling::Transaction*,size_t> fTransactionHeadersMap; // Map which transaction contains which autoparse.
    std::set<size_t> fLookedUpClasses; // Set of classes for which headers were looked up already
+   mutable std::unordered_map<std::string, bool> fIsEnumCache; // ClassInfo_IsEnum() of names that resolved; guarded by gInterpreterMutex
+   std::vector<std::pair<std::string, std::string>> fNewDeclaredNames; // Names declared since the last TakeNewDeclaredNames()
+   Bool_t          fNewDeclaredNamesValid = kFALSE; // Whether fNewDeclaredNames is being recorded and complete
    std::set<size_t> fPayloads; // Set of payloads
    std::set<const char*> fParsedPayloadsAddresses; // Set of payloads which were parsed
    std::hash<std::string> fStringHashFunction; // A simple hashing function
@@ -216,6 +221,7 @@ public: // Public Interface
    virtual const char* GetSTLIncludePath() const;
    TObjArray*  GetRootMapFiles() const { return fRootmapFiles; }
    ULong64_t GetInterpreterStateMarker() const { return fTransactionCount;}
+   Bool_t  TakeNewDeclaredNames(std::vector<std::pair<std::string, std::string>> &names);
    virtual void Initialize();
    virtual void ShutDown();
    void    InspectMembers(TMemberInspector&, const void* obj, const TClass* cl, Bool_t isTransient);
@@ -348,8 +354,12 @@ public: // Public Interface
    virtual MethodInfo_t* CallFunc_FactoryMethod(CallFunc_t* func) const;
    virtual void   CallFunc_Init(CallFunc_t* func) const;
    virtual bool   CallFunc_IsValid(CallFunc_t* func) const;
+   virtual bool   CallFunc_IsNoexcept(CallFunc_t* func) const;
    virtual CallFuncIFacePtr_t CallFunc_IFacePtr(CallFunc_t* func, bool as_iface) const;
+   virtual CallFuncBatch_t CallFunc_BatchIFacePtr(CallFunc_t* func, bool as_iface) const;
+   virtual void   CallFunc_IFacePtrs(const std::vector<CallFunc_t*>& funcs, bool as_iface, std::vector<CallFuncIFacePtr_t>& res) const;
    virtual void   CallFunc_SetFunc(CallFunc_t* func, MethodInfo_t* info) const;
+   virtual void   CallFunc_SetArgLayout(size_t stride, size_t value_offset, size_t ref_offset, size_t type_offset) const;
 
    virtual std::string CallFunc_GetWrapperCode(CallFunc_t* func, bool as_iface) const;
 
@@ -517,6 +527,9 @@ public: // Public Interface
    void LibraryUnloaded(const void* dyLibHandle, const char* canonicalName);
 
 private: // Private Utility Functions and Classes
+   void RecordDeclaredName(const clang::Decl *D, bool isDeserialized);
+   void RecordRootmapEntries(Int_t first);
+   void InvalidateDeclaredNames();
    template <typename List, typename Object>
    static void RemoveAndInvalidateObject(List &L, Object *O) {
       // Invalidate stored information by setting the `xxxInfo_t' to nullptr.
@@ -562,10 +575,25 @@ private: // Private Utility Functions and Classes
    std::map<std::string, llvm::StringRef> fPendingRdicts;
    void RegisterRdictForLoadPCM(const std::string &pcmFileNameFullPath, llvm::StringRef *pcmContent);
    void LoadPCM(std::string pcmFileNameFullPath);
-   void LoadPCMImpl(TFile &pcmFile);
+
+   // PCM contents with proto classes that are deserialized on first use.
+   struct TPendingProtoClasses {
+      std::string fFileName;
+      const char *fData = nullptr;       // either mapped or in fCopy
+      size_t      fSize = 0;
+      bool        fMapped = false;       // if true, unmap once loaded
+      bool        fDeferred = false;     // set by LoadPCMImpl if lazy loading applies
+      std::string fCopy;                 // deferred content that is owned by a library
+   };
+   std::list<TPendingProtoClasses> fPendingProtoClasses;
+   void LoadPCMImpl(TFile &pcmFile, TPendingProtoClasses *pending = nullptr);
+   void LoadPCMContent(TPendingProtoClasses &pending);
+   static void LoadPendingProtoClasses(const void *token);
 
    void InitRootmapFile(const char *name);
    int  ReadRootmapFile(const char *rootmapfile, TUniqueString* uniqueString = nullptr);
+   int  ReadRootmapIndex(const TMetaUtils::TRootmapIndex &index, const std::string &rootmapfile,
+                         TUniqueString *uniqueString);
    Bool_t HandleNewTransaction(const cling::Transaction &T);
    bool IsClassAutoloadingEnabled() const;
    void ProcessClassesToUpdate();
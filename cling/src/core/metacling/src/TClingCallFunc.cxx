@@ -28,6 +28,7 @@ C++ interpreter and the Clang C++ compiler, not CINT.
 #include "TClingMethodInfo.h"
 #include "TInterpreterValue.h"
 #include "TClingUtils.h"
+#include "TInstrumentation.h"
 #include "TSystem.h"
 
 #include "TError.h"
@@ -47,6 +48,7 @@ C++ interpreter and the Clang C++ compiler, not CINT.
 #include "clang/AST/PrettyPrinter.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Sema/Sema.h"
@@ -68,6 +70,7 @@ C++ interpreter and the Clang C++ compiler, not CINT.
 
 #include <iomanip>
 #include <map>
+#include <set>
 #include <string>
 #include <sstream>
 
@@ -93,6 +96,25 @@ static inline WrapperStore_t& get_wrapper_store(bool as_iface) {
 static map<const Decl *, void *> gCtorWrapperStore;
 static map<const Decl *, void *> gDtorWrapperStore;
 
+// Wrappers that take the caller's argument array directly (see SetArgLayout).
+static WrapperStore_t gArgsWrapperStoreInherited;
+static WrapperStore_t gArgsWrapperStoreDirect;
+static inline WrapperStore_t& get_args_wrapper_store(bool as_iface) {
+   if (as_iface) return gArgsWrapperStoreInherited;
+   return gArgsWrapperStoreDirect;
+}
+typedef map<const FunctionDecl*, void*> BatchWrapperStore_t;
+static BatchWrapperStore_t gBatchWrapperStoreInherited;
+static BatchWrapperStore_t gBatchWrapperStoreDirect;
+static inline BatchWrapperStore_t& get_batch_wrapper_store(bool as_iface) {
+   if (as_iface) return gBatchWrapperStoreInherited;
+   return gBatchWrapperStoreDirect;
+}
+static size_t gArgStride = 0;
+static size_t gArgValueOffset = 0;
+static size_t gArgRefOffset = 0;
+static size_t gArgTypeOffset = 0;
+
 static inline
 void indent(ostringstream &buf, int indent_level)
 {
@@ -107,6 +129,78 @@ size_t TClingCallFunc::CalculateMinRequiredArguments()
    return GetDecl()->getMinRequiredArguments();
 }
 
+void TClingCallFunc::SetArgLayout(size_t stride, size_t value_offset, size_t ref_offset, size_t type_offset)
+{
+   // Set the layout of the argument array of the caller, for which a thunk
+   // is generated alongside every wrapper. Each argument is a struct of the
+   // given stride that holds the value (or a pointer to it), a reference
+   // pointer, and a type code that selects which of these to pass:
+   //    'V', 'X': the value is a pointer to the object
+   //    'r':      the reference pointer points to the object
+   //    other:    the value itself is the object
+   // A stride of 0 disables the generation of thunks.
+   R__LOCKGUARD_CLING(gInterpreterMutex);
+   gArgStride = stride;
+   gArgValueOffset = value_offset;
+   gArgRefOffset = ref_offset;
+   gArgTypeOffset = type_offset;
+}
+
+static string make_args_thunk(const string &wrapper_name, const FunctionDecl *FD)
+{
+   // Make a code string that follows this pattern:
+   //
+   // void
+   // wrapper_name_a(void* obj, int nargs, void* vargs, void* ret)
+   // {
+   //    void* args[num_params];
+   //    if (nargs > num_params) nargs = num_params;
+   //    for (int i = 0; i < nargs; ++i) {
+   //       char* a = (char*)vargs + i*stride;
+   //       char tc = a[type_offset];
+   //       args[i] = (tc == 'V' || tc == 'X') ? *(void**)(a+value_offset) :
+   //                 (tc == 'r' ? *(void**)(a+ref_offset) : (void*)(a+value_offset));
+   //    }
+   //    wrapper_name(obj, nargs, args, ret);
+   // }
+   //
+   // The pointer array lives on the thunk's stack and is sized by the
+   // number of parameters, so no array is allocated by the caller; with
+   // the constants inlined, the optimizer can keep it in registers. The
+   // thunk is always compiled in the same transaction as the wrapper. The
+   // number of arguments comes from the caller, so it is clipped to the size
+   // of the array; variadic functions, which take more, get no thunk.
+   if (!gArgStride || FD->isVariadic())
+      return "";
+
+   const unsigned num_params = FD->getNumParams();
+
+   ostringstream buf;
+   buf << "\n__attribute__((used)) extern \"C\" void " << wrapper_name << "_a"
+       << "(void* obj, int nargs, void* vargs, void* ret)\n"
+          "{\n";
+   indent(buf, 1);
+   buf << "void* args[" << (num_params ? num_params : 1) << "];\n";
+   indent(buf, 1);
+   buf << "if (nargs > " << num_params << ") nargs = " << num_params << ";\n";
+   indent(buf, 1);
+   buf << "for (int i = 0; i < nargs; ++i) {\n";
+   indent(buf, 2);
+   buf << "char* a = (char*)vargs + i*" << gArgStride << ";\n";
+   indent(buf, 2);
+   buf << "char tc = a[" << gArgTypeOffset << "];\n";
+   indent(buf, 2);
+   buf << "args[i] = (tc == 'V' || tc == 'X') ? *(void**)(a+" << gArgValueOffset << ") :\n";
+   indent(buf, 2);
+   buf << "   (tc == 'r' ? *(void**)(a+" << gArgRefOffset << ") : (void*)(a+" << gArgValueOffset << "));\n";
+   indent(buf, 1);
+   buf << "}\n";
+   indent(buf, 1);
+   buf << wrapper_name << "(obj, nargs, args, ret);\n"
+          "}\n";
+   return buf.str();
+}
+
 void *TClingCallFunc::compile_wrapper(const string &wrapper_name, const string &wrapper,
                                       bool withAccessControl/*=true*/)
 {
@@ -1090,6 +1184,8 @@ tcling_callfunc_Wrapper_t TClingCallFunc::make_wrapper(bool as_iface)
    R__LOCKGUARD_CLING(gInterpreterMutex);
 
    const FunctionDecl *FD = GetDecl();
+   TInstrumentation::TTimer timer(TInstrumentation::kWrapperJIT,
+      TInstrumentation::IsEnabled() && TInstrumentation::GetTopN() ? FD->getQualifiedNameAsString().c_str() : nullptr);
    string wrapper_name;
    string wrapper;
 
@@ -1097,11 +1193,16 @@ tcling_callfunc_Wrapper_t TClingCallFunc::make_wrapper(bool as_iface)
 
    //fprintf(stderr, "%s\n", wrapper.c_str());
    //
-   //  Compile the wrapper code.
+   //  Compile the wrapper code, with the argument thunk (if any).
    //
-   void *F = compile_wrapper(wrapper_name, wrapper);
+   const string thunk = make_args_thunk(wrapper_name, FD);
+   void *F = compile_wrapper(wrapper_name, wrapper + thunk);
    if (F) {
       get_wrapper_store(as_iface).insert(make_pair(FD, F));
+      if (!thunk.empty()) {
+         if (void *A = fInterp->getAddressOfGlobal(wrapper_name + "_a"))
+            get_args_wrapper_store(as_iface).insert(make_pair(FD, A));
+      }
    } else {
       ::CppyyLegacy::Error("TClingCallFunc::make_wrapper",
             "Failed to compile\n  ==== SOURCE BEGIN ====\n%s\n  ==== SOURCE END ====",
@@ -1110,6 +1211,154 @@ tcling_callfunc_Wrapper_t TClingCallFunc::make_wrapper(bool as_iface)
    return (tcling_callfunc_Wrapper_t)F;
 }
 
+void TClingCallFunc::MakeWrappers(const std::vector<TClingCallFunc*> &funcs, bool as_iface)
+{
+   // Generate the wrappers for all given functions that do not have one yet,
+   // and compile them together in a single transaction, thus paying the
+   // parse, codegen, and link overhead only once. If the combined code fails
+   // to compile (e.g. because of a single bad wrapper), fall back to compiling
+   // them one by one, so that the good ones are still available.
+   if (funcs.empty())
+      return;
+
+   R__LOCKGUARD_CLING(gInterpreterMutex);
+   TInstrumentation::TTimer timer(TInstrumentation::kWrapperJIT, "(batch)");
+
+   struct PendingWrapper_t {
+      TClingCallFunc *fFunc;
+      string fName;
+      string fCode;
+   };
+   vector<PendingWrapper_t> pending;
+   pending.reserve(funcs.size());
+
+   WrapperStore_t &wstore = get_wrapper_store(as_iface);
+   std::set<const FunctionDecl *> seen;
+   cling::Interpreter *interp = nullptr;
+   for (auto cf : funcs) {
+      if (!cf || cf->fWrapper || !cf->IsValid())
+         continue;
+      const FunctionDecl *FD = cf->GetDecl();
+      if (wstore.find(FD) != wstore.end() || !seen.insert(FD).second)
+         continue;
+      PendingWrapper_t pw{cf, "", ""};
+      if (cf->get_wrapper_code(pw.fName, pw.fCode, as_iface) == 0)
+         continue;
+      interp = cf->fInterp;
+      pending.push_back(std::move(pw));
+   }
+
+   if (!pending.empty()) {
+      string code;
+      for (const auto &pw : pending) {
+         code += pw.fCode;
+         code += '\n';
+         code += make_args_thunk(pw.fName, pw.fFunc->GetDecl());
+      }
+
+      void *F0 = interp->compileFunction(pending[0].fName, code, false /*ifUnique*/,
+                                         false /* withAccessControl */);
+      if (F0) {
+         for (auto &pw : pending) {
+            void *F = &pw == &pending[0] ? F0 : interp->getAddressOfGlobal(pw.fName);
+            if (!F)
+               continue;
+            wstore.insert(make_pair(pw.fFunc->GetDecl(), F));
+            if (gArgStride) {
+               if (void *A = interp->getAddressOfGlobal(pw.fName + "_a"))
+                  get_args_wrapper_store(as_iface).insert(make_pair(pw.fFunc->GetDecl(), A));
+            }
+         }
+      } else {
+         for (auto &pw : pending)
+            pw.fFunc->make_wrapper(as_iface);
+      }
+   }
+
+   for (auto cf : funcs) {
+      if (!cf || cf->fWrapper || !cf->IsValid())
+         continue;
+      WrapperStore_t::iterator I = wstore.find(cf->GetDecl());
+      if (I != wstore.end())
+         cf->fWrapper = (tcling_callfunc_Wrapper_t) I->second;
+   }
+}
+
+tcling_callfunc_batch_Wrapper_t TClingCallFunc::make_batch_wrapper(bool as_iface)
+{
+   // Make a code string that follows this pattern:
+   //
+   // <wrapper code for wrapper_name, see get_wrapper_code>
+   //
+   // void
+   // wrapper_name_b(void** selves, int nargs, void** columns, const size_t* strides,
+   //                size_t n, void* out, size_t out_stride)
+   // {
+   //    void* args[num_params];
+   //    if (nargs > num_params) nargs = num_params;
+   //    for (size_t k = 0; k < n; ++k) {
+   //       for (int i = 0; i < nargs; ++i)
+   //          args[i] = (char*)columns[i] + k*strides[i];
+   //       wrapper_name(selves ? selves[k] : 0, nargs, args,
+   //                    out ? (char*)out + k*out_stride : 0);
+   //    }
+   // }
+   //
+   // The wrapper is compiled anew with the loop, in the same transaction,
+   // so that it can be inlined into the loop body. As for the args thunk, the
+   // number of columns comes from the caller and is clipped to the size of the
+   // array, and variadic functions are not supported. The size type is spelled
+   // __SIZE_TYPE__, so that no header is needed.
+   R__LOCKGUARD_CLING(gInterpreterMutex);
+
+   const FunctionDecl *FD = GetDecl();
+   if (FD->isVariadic()) {
+      ::CppyyLegacy::Error("TClingCallFunc::make_batch_wrapper",
+            "Batched calls of variadic function %s are not supported",
+            FD->getNameAsString().c_str());
+      return 0;
+   }
+
+   string wrapper_name;
+   string wrapper;
+   if (get_wrapper_code(wrapper_name, wrapper, as_iface) == 0) return 0;
+
+   const string batch_name = wrapper_name + "_b";
+   const unsigned num_params = FD->getNumParams();
+   ostringstream buf;
+   buf << wrapper << "\n"
+          "__attribute__((used)) extern \"C\" void " << batch_name
+       << "(void** selves, int nargs, void** columns, const __SIZE_TYPE__* strides,\n"
+          "   __SIZE_TYPE__ n, void* out, __SIZE_TYPE__ out_stride)\n"
+          "{\n";
+   indent(buf, 1);
+   buf << "void* args[" << (num_params ? num_params : 1) << "];\n";
+   indent(buf, 1);
+   buf << "if (nargs > " << num_params << ") nargs = " << num_params << ";\n";
+   indent(buf, 1);
+   buf << "for (__SIZE_TYPE__ k = 0; k < n; ++k) {\n";
+   indent(buf, 2);
+   buf << "for (int i = 0; i < nargs; ++i)\n";
+   indent(buf, 3);
+   buf << "args[i] = (char*)columns[i] + k*strides[i];\n";
+   indent(buf, 2);
+   buf << wrapper_name << "(selves ? selves[k] : 0, nargs, args, out ? (char*)out + k*out_stride : 0);\n";
+   indent(buf, 1);
+   buf << "}\n"
+          "}\n";
+   string code(buf.str());
+
+   void *F = compile_wrapper(batch_name, code);
+   if (F) {
+      get_batch_wrapper_store(as_iface).insert(make_pair(FD, F));
+   } else {
+      ::CppyyLegacy::Error("TClingCallFunc::make_batch_wrapper",
+            "Failed to compile\n  ==== SOURCE BEGIN ====\n%s\n  ==== SOURCE END ====",
+            code.c_str());
+   }
+   return (tcling_callfunc_batch_Wrapper_t)F;
+}
+
 tcling_callfunc_ctor_Wrapper_t TClingCallFunc::make_ctor_wrapper(const TClingClassInfo *info)
 {
    // Make a code string that follows this pattern:
@@ -1549,6 +1798,59 @@ bool TClingCallFunc::IsValid() const
    return fMethod->IsValid();
 }
 
+static bool is_nothrow(Sema &S, const FunctionDecl *FD)
+{
+   // Implicit members and instantiations may not have their exception spec
+   // evaluated yet; do so now, rather than treating them as throwing.
+   const FunctionProtoType *FPT = FD->getType()->getAs<FunctionProtoType>();
+   if (FPT && isUnresolvedExceptionSpec(FPT->getExceptionSpecType()))
+      FPT = S.ResolveExceptionSpec(FD->getLocation(), FPT);
+   return FPT && FPT->isNothrow();
+}
+
+bool TClingCallFunc::IsNoexcept() const
+{
+   // True if the wrapper of the target function can not throw: the function
+   // itself can not, either as declared (noexcept, throw()) or implied (e.g.
+   // destructors), and neither can the copies (and their destruction) of the
+   // arguments that the wrapper passes by value. Dependent specs, and classes
+   // without a usable copy constructor, count as throwing.
+   if (!IsValid())
+      return false;
+   const FunctionDecl *FD = GetDecl();
+   if (!FD)
+      return false;
+
+   R__LOCKGUARD_CLING(gInterpreterMutex);
+   Sema &S = fInterp->getSema();
+   // Lookups can declare implicit members and instantiate templates.
+   cling::Interpreter::PushTransactionRAII RAII(fInterp);
+   if (!is_nothrow(S, FD))
+      return false;
+   for (const ParmVarDecl *PVD : FD->parameters()) {
+      QualType QT = PVD->getType().getCanonicalType();
+      if (QT->isReferenceType())
+         continue;
+      CXXRecordDecl *RD = QT->getAsCXXRecordDecl();
+      if (!RD)
+         continue;
+      if (!RD->hasDefinition())
+         return false;
+      // Same choice between copy and move as in make_narg_call.
+      CXXConstructorDecl *Ctor = nullptr;
+      if (RD->hasTrivialCopyConstructor() && !RD->hasSimpleCopyConstructor() && RD->hasMoveConstructor())
+         Ctor = S.LookupMovingConstructor(RD, 0);
+      else
+         Ctor = S.LookupCopyingConstructor(RD, 0);
+      if (!Ctor || Ctor->isDeleted() || !is_nothrow(S, Ctor))
+         return false;
+      CXXDestructorDecl *Dtor = S.LookupDestructor(RD);
+      if (!Dtor || !is_nothrow(S, Dtor))
+         return false;
+   }
+   return true;
+}
+
 TInterpreter::CallFuncIFacePtr_t TClingCallFunc::IFacePtr(bool as_iface)
 {
    if (!IsValid()) {
@@ -1568,7 +1870,32 @@ TInterpreter::CallFuncIFacePtr_t TClingCallFunc::IFacePtr(bool as_iface)
          fWrapper = make_wrapper(as_iface);
       }
    }
-   return TInterpreter::CallFuncIFacePtr_t(fWrapper, as_iface);
+   TInterpreter::CallFuncIFacePtr_t faceptr(fWrapper, as_iface);
+   if (fWrapper && gArgStride) {
+      R__LOCKGUARD_CLING(gInterpreterMutex);
+      WrapperStore_t& astore = get_args_wrapper_store(as_iface);
+      WrapperStore_t::iterator I = astore.find(GetDecl());
+      if (I != astore.end())
+         faceptr.fArgs = (TInterpreter::CallFuncIFacePtr_t::Generic_t) I->second;
+   }
+   return faceptr;
+}
+
+TInterpreter::CallFuncBatch_t TClingCallFunc::BatchIFacePtr(bool as_iface)
+{
+   if (!IsValid()) {
+      ::CppyyLegacy::Error("TClingCallFunc::BatchIFacePtr(kind)",
+            "Attempt to get interface while invalid.");
+      return nullptr;
+   }
+   const FunctionDecl *decl = GetDecl();
+
+   R__LOCKGUARD_CLING(gInterpreterMutex);
+   BatchWrapperStore_t& bstore = get_batch_wrapper_store(as_iface);
+   BatchWrapperStore_t::iterator I = bstore.find(decl);
+   if (I != bstore.end())
+      return (TInterpreter::CallFuncBatch_t) I->second;
+   return (TInterpreter::CallFuncBatch_t) make_batch_wrapper(as_iface);
 }
 
 void TClingCallFunc::SetFunc(const TClingClassInfo *info, const char *method, const char *arglist,
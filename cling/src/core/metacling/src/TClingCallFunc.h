@@ -59,6 +59,8 @@ namespace CppyyLegacy {
 typedef void (*tcling_callfunc_Wrapper_t)(void*, int, void**, void*);
 typedef void (*tcling_callfunc_ctor_Wrapper_t)(void**, void*, unsigned long);
 typedef void (*tcling_callfunc_dtor_Wrapper_t)(void*, unsigned long, int);
+typedef void (*tcling_callfunc_batch_Wrapper_t)(void**, int, void**, const size_t*,
+                                                size_t, void*, size_t);
 
 class TClingCallFunc {
 
@@ -109,6 +111,7 @@ private:
    tcling_callfunc_Wrapper_t      make_wrapper(bool as_iface);
    tcling_callfunc_ctor_Wrapper_t make_ctor_wrapper(const TClingClassInfo* info);
    tcling_callfunc_dtor_Wrapper_t make_dtor_wrapper(const TClingClassInfo* info);
+   tcling_callfunc_batch_Wrapper_t make_batch_wrapper(bool as_iface);
 
    size_t CalculateMinRequiredArguments();
 
@@ -156,7 +159,11 @@ public:
    void Init(std::unique_ptr<TClingMethodInfo>);
    void* InterfaceMethod(bool as_iface);
    bool IsValid() const;
+   bool IsNoexcept() const;
    TInterpreter::CallFuncIFacePtr_t IFacePtr(bool as_iface);
+   TInterpreter::CallFuncBatch_t BatchIFacePtr(bool as_iface);
+   static void MakeWrappers(const std::vector<TClingCallFunc*>& funcs, bool as_iface);
+   static void SetArgLayout(size_t stride, size_t value_offset, size_t ref_offset, size_t type_offset);
    const clang::FunctionDecl *GetDecl() {
       if (!fDecl)
          fDecl = fMethod->GetMethodDecl();
@@ -918,6 +918,12 @@ bool TClingClassInfo::IsLoaded() const
       return false;
    }
 
+   {
+      R__READ_LOCKGUARD_CLING(gInterpreterMutex);
+      if (fMemoDecl == GetDecl() && fMemoIsLoaded)
+         return true;
+   }
+
    R__LOCKGUARD(gInterpreterMutex);
 
    const CXXRecordDecl *CRD = llvm::dyn_cast<CXXRecordDecl>(GetDecl());
@@ -932,6 +938,8 @@ bool TClingClassInfo::IsLoaded() const
       }
    }
    // All clang classes are considered loaded.
+   ResetMemo();
+   fMemoIsLoaded = true;
    return true;
 }
 
@@ -1247,13 +1255,32 @@ void *TClingClassInfo::New(void *arena, const TMetaUtils::TNormalizedCtxt &normC
    return obj;
 }
 
+void TClingClassInfo::ResetMemo() const
+{
+   // Drop memoized results of a previous decl (this may be an iterator);
+   // must be called with the interpreter write lock held.
+   if (fMemoDecl != GetDecl()) {
+      fMemoDecl = GetDecl();
+      fMemoProperty = -1L;
+      fMemoSize = -1;
+      fMemoIsLoaded = false;
+   }
+}
+
 long TClingClassInfo::Property() const
 {
    if (!IsValid()) {
       return 0L;
    }
 
+   {
+      R__READ_LOCKGUARD_CLING(gInterpreterMutex);
+      if (fMemoDecl == GetDecl() && fMemoProperty != -1L)
+         return fMemoProperty;
+   }
+
    R__LOCKGUARD(gInterpreterMutex);
+   ResetMemo();
 
    long property = 0L;
    property |= kIsCPPCompiled;
@@ -1273,7 +1300,7 @@ long TClingClassInfo::Property() const
    Decl::Kind DK = GetDecl()->getKind();
    if ((DK == Decl::Namespace) || (DK == Decl::TranslationUnit)) {
       property |= kIsNamespace;
-      return property;
+      return fMemoProperty = property;
    }
    // Note: Now we have class, enum, struct, union only.
    const TagDecl *TD = llvm::dyn_cast<TagDecl>(GetDecl());
@@ -1282,7 +1309,7 @@ long TClingClassInfo::Property() const
    }
    if (TD->isEnum()) {
       property |= kIsEnum;
-      return property;
+      return fMemoProperty = property;
    }
    // Note: Now we have class, struct, union only.
    const CXXRecordDecl *CRD =
@@ -1296,8 +1323,10 @@ long TClingClassInfo::Property() const
    else if (CRD->isUnion()) {
       property |= kIsUnion;
    }
-   if (CRD->hasDefinition() && CRD->isAbstract()) {
-      property |= kIsAbstract;
+   if (CRD->hasDefinition()) {
+      if (CRD->isAbstract())
+         property |= kIsAbstract;
+      fMemoProperty = property;
    }
    return property;
 }
@@ -1321,16 +1350,23 @@ int TClingClassInfo::Size() const
       return 0;
    }
 
+   {
+      R__READ_LOCKGUARD_CLING(gInterpreterMutex);
+      if (fMemoDecl == GetDecl() && fMemoSize != -1)
+         return fMemoSize;
+   }
+
    R__LOCKGUARD(gInterpreterMutex);
+   ResetMemo();
 
    Decl::Kind DK = GetDecl()->getKind();
    if (DK == Decl::Namespace) {
       // Namespaces are special for cint.
-      return 1;
+      return fMemoSize = 1;
    }
    else if (DK == Decl::Enum) {
       // Enums are special for cint.
-      return 0;
+      return fMemoSize = 0;
    }
    const RecordDecl *RD = llvm::dyn_cast<RecordDecl>(GetDecl());
    if (!RD) {
@@ -1346,7 +1382,7 @@ int TClingClassInfo::Size() const
    const ASTRecordLayout &Layout = Context.getASTRecordLayout(RD);
    int64_t size = Layout.getSize().getQuantity();
    int clang_size = static_cast<int>(size);
-   return clang_size;
+   return fMemoSize = clang_size;
 }
 
 long TClingClassInfo::Tagnum() const
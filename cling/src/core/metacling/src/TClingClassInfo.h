@@ -70,6 +70,15 @@ private:
    std::string           fTitle; // The meta info for the class.
    std::string           fDeclFileName; // Name of the file where the underlying entity is declared.
    llvm::DenseMap<const clang::Decl*, std::pair<ptrdiff_t, OffsetPtrFunc_t> > fOffsetCache; // Functions already generated for offsets.
+   // Results of IsLoaded(), Property(), and Size() that can no longer change for
+   // fMemoDecl (e.g. the class is complete); guarded by gInterpreterMutex, so that
+   // these can be served under the shared (read) lock.
+   mutable const clang::Decl *fMemoDecl = nullptr;
+   mutable long          fMemoProperty = -1L;
+   mutable int           fMemoSize = -1;
+   mutable bool          fMemoIsLoaded = false;
+
+   void                  ResetMemo() const;
 
 public: // Types
 
@@ -0,0 +1,207 @@
+// Throughput of compression and decompression (see R__zipMultipleBlocks in
+// RZip.cxx), in MB/s of uncompressed data, across algorithms, buffer sizes,
+// compression levels and thread counts. Each round trip is verified against
+// the input.
+//
+// Standalone, as it only needs the zip sources; from the top of the tree
+// (with the same include paths as the Core library, and zlib):
+//
+//    c++ -std=c++14 -O2 -Icore/zip/inc -Icore/zip/src -Icore/base/inc -Icore/foundation/inc
+//        core/zip/bench/zip_bench.cxx core/zip/src/RZip.cxx core/zip/src/Bits.c
+//        core/zip/src/ZDeflate.c core/zip/src/ZTrees.c core/zip/src/ZInflate.c -lz -pthread
+//
+// adding -DR__HAS_LZ4 core/zip/src/ZipLZ4.cxx -llz4 and/or -DR__HAS_ZSTD
+// core/zip/src/ZipZSTD.cxx -lzstd for those algorithms.
+//
+// Options: --threads <n> (largest thread count, default: number of cores),
+// --repeat <n> (default 5), --algorithms <list> (comma separated, default:
+// zlib,lz4,zstd; those not built in are skipped), and --input <file> to use
+// the contents of a file instead of synthetic buffers. For the decompression
+// part of loading dictionary PCMs, use an uncompressed one (written with
+// "rootcling -compressPCM=0") as input. Results are written as JSON to stdout.
+
+#include "RZip.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+using EAlgorithm = CppyyLegacy::RCompressionSetting::EAlgorithm;
+
+struct Algorithm {
+   const char *fName;
+   EAlgorithm::EValues fValue;
+   char fMagic[2];               // header of its chunks
+   std::vector<int> fLevels;
+};
+
+const Algorithm gAlgorithms[] = {
+   {"zlib", EAlgorithm::kZLIB, {'Z', 'L'}, {1, 6, 9}},
+   {"lz4",  EAlgorithm::kLZ4,  {'L', '4'}, {1, 4, 9}},
+   {"zstd", EAlgorithm::kZSTD, {'Z', 'S'}, {1, 5, 9}}
+};
+
+// algorithms that are not built in silently fall back to zlib
+bool IsAvailable(const Algorithm &algo)
+{
+   std::vector<char> in(4096, 'a'), out(4096);
+   int srcsize = (int)in.size(), tgtsize = (int)out.size(), nout = 0;
+   R__zipMultipleAlgorithm(1, &srcsize, in.data(), &tgtsize, out.data(), &nout, algo.fValue);
+   return nout && out[0] == algo.fMagic[0] && out[1] == algo.fMagic[1];
+}
+
+struct Result {
+   std::string fName;
+   double fRatio;
+   std::vector<double> fSamples;     // MB/s
+};
+
+// compressible but not trivially so: text-like runs over a small alphabet,
+// mixed with slowly varying binary numbers (as in streamed object buffers)
+std::vector<char> MakeInput(size_t size)
+{
+   std::vector<char> buf(size);
+   unsigned seed = 12345;
+   for (size_t i = 0; i < size; ) {
+      seed = seed*1103515245 + 12345;
+      if ((seed >> 16) & 1) {
+         size_t n = std::min(size - i, (size_t)(8 + (seed >> 24) % 32));
+         for (size_t j = 0; j < n; ++j)
+            buf[i+j] = "etaoinshrdlu  "[(seed >> (j%16)) % 14];
+         i += n;
+      } else {
+         int v = (int)(i/64) ^ (int)((seed >> 20) & 0x7);
+         size_t n = std::min(size - i, sizeof(v));
+         memcpy(&buf[i], &v, n);
+         i += n;
+      }
+   }
+   return buf;
+}
+
+double MBs(size_t size, std::chrono::steady_clock::time_point start)
+{
+   double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   return size/s/1e6;
+}
+
+} // unnamed namespace
+
+int main(int argc, char **argv)
+{
+   int maxthreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+   int repeat = 5;
+   std::string algorithms = "zlib,lz4,zstd", input;
+   for (int i = 1; i + 1 < argc; i += 2) {
+      if (strcmp(argv[i], "--threads") == 0)
+         maxthreads = std::max(atoi(argv[i+1]), 1);
+      else if (strcmp(argv[i], "--repeat") == 0)
+         repeat = std::max(atoi(argv[i+1]), 1);
+      else if (strcmp(argv[i], "--algorithms") == 0)
+         algorithms = argv[i+1];
+      else if (strcmp(argv[i], "--input") == 0)
+         input = argv[i+1];
+      else {
+         fprintf(stderr, "usage: %s [--threads <n>] [--repeat <n>] [--algorithms <list>] [--input <file>]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   std::vector<const Algorithm *> algos;
+   for (auto &algo : gAlgorithms) {
+      if (("," + algorithms + ",").find(std::string(",") + algo.fName + ",") == std::string::npos)
+         continue;
+      if (IsAvailable(algo))
+         algos.push_back(&algo);
+      else
+         fprintf(stderr, "%s: not available in this build, skipped\n", algo.fName);
+   }
+
+// either the given file, or synthetic buffers of several sizes
+   std::vector<std::pair<std::string, std::vector<char>>> inputs;
+   if (!input.empty()) {
+      std::ifstream f(input, std::ios::binary);
+      std::vector<char> buf{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+      if (buf.size() < 64) {
+         fprintf(stderr, "%s: can not read, or too small\n", input.c_str());
+         return 2;
+      }
+      std::string name = input.substr(input.rfind('/') + 1);
+      inputs.emplace_back(name, std::move(buf));
+   } else {
+      for (int mb : {1, 4, 16, 64})
+         inputs.emplace_back(std::to_string(mb) + "MB", MakeInput((size_t)mb << 20));
+   }
+
+   std::vector<int> threads{1};
+   for (int n = 2; n < maxthreads; n *= 2)
+      threads.push_back(n);
+   if (maxthreads > 1)
+      threads.push_back(maxthreads);
+
+   std::vector<Result> results;
+   for (auto &in : inputs) {
+      const size_t size = in.second.size();
+      const std::vector<char> &input = in.second;
+      std::vector<char> zipped(size + size/16 + 1024);
+      std::vector<char> unzipped(size);
+      for (auto algo : algos) {
+         for (int level : algo->fLevels) {
+            for (int nthreads : threads) {
+               std::string tag = std::string(algo->fName) + "/" + in.first + "/level" + std::to_string(level) +
+                                 "/threads" + std::to_string(nthreads);
+               Result zip{"zip/" + tag, 0., {}}, unzip{"unzip/" + tag, 0., {}};
+               for (int irep = 0; irep < repeat; ++irep) {
+                  int srcsize = (int)size, tgtsize = (int)zipped.size(), nzip = 0;
+                  auto start = std::chrono::steady_clock::now();
+                  R__zipMultipleBlocks(level, &srcsize, const_cast<char *>(input.data()), &tgtsize, zipped.data(), &nzip,
+                                       algo->fValue, nthreads);
+                  zip.fSamples.push_back(MBs(size, start));
+                  if (!nzip) {
+                     fprintf(stderr, "%s: compression failed\n", tag.c_str());
+                     return 1;
+                  }
+                  zip.fRatio = unzip.fRatio = (double)size/nzip;
+
+                  int outsize = (int)size, nout = 0;
+                  start = std::chrono::steady_clock::now();
+                  R__unzipMultipleBlocks(&nzip, (unsigned char *)zipped.data(), &outsize,
+                                         (unsigned char *)unzipped.data(), &nout, nthreads);
+                  unzip.fSamples.push_back(MBs(size, start));
+                  if (nout != (int)size || memcmp(input.data(), unzipped.data(), size) != 0) {
+                     fprintf(stderr, "%s: round trip failed\n", tag.c_str());
+                     return 1;
+                  }
+               }
+               results.push_back(zip);
+               results.push_back(unzip);
+            }
+         }
+      }
+   }
+
+   printf("{\n  \"results\": [");
+   const char *sep = "\n";
+   for (auto &r : results) {
+      std::vector<double> s = r.fSamples;
+      std::sort(s.begin(), s.end());
+      double median = s.size() % 2 ? s[s.size()/2] : (s[s.size()/2-1] + s[s.size()/2])/2.;
+      printf("%s    {\"name\": \"%s\", \"unit\": \"MB/s\", \"ratio\": %.2f, \"samples\": %zu, "
+             "\"min\": %.1f, \"median\": %.1f, \"max\": %.1f}",
+             sep, r.fName.c_str(), r.fRatio, s.size(), s.front(), median, s.back());
+      sep = ",\n";
+   }
+   printf("\n  ]\n}\n");
+
+   return 0;
+}
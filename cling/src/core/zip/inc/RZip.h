@@ -33,6 +33,37 @@ extern "C" void R__unzip(int *srcsize, unsigned char *src, int *tgtsize, unsigne
 
 extern "C" int R__unzip_header(int *srcsize, unsigned char *src, int *tgtsize);
 
+/**
+ * Compress a buffer of any size into consecutive, independently compressed chunks (the layout
+ * that readers of buffers larger than kMAXZIPBUF expect), using up to nthreads threads for buffers
+ * of several blocks; nthreads < 0 selects the global setting, 0 the number of cores. *irep is 0 if
+ * the buffer could not be compressed into *tgtsize bytes.
+ */
+extern "C" void R__zipMultipleBlocks(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep,
+                                     CppyyLegacy::RCompressionSetting::EAlgorithm::EValues, int nthreads);
+
+/**
+ * Decompress a sequence of chunks into *tgtsize bytes, using up to nthreads threads; *irep is the
+ * number of bytes decompressed, or 0 on error.
+ */
+extern "C" void R__unzipMultipleBlocks(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep,
+                                       int nthreads);
+
+/**
+ * Global number of threads for (de)compressing large buffers; 0 selects the number of cores. The
+ * default is 1 (serial), or taken from $CPPYY_ZIP_THREADS.
+ */
+extern "C" void R__SetZipThreads(int nthreads);
+extern "C" int R__GetZipThreads();
+
+/**
+ * For fork handlers: take the locks of the (de)compression threads before fork(), to be released
+ * in the parent and the child, respectively. The child starts new threads when needed.
+ */
+extern "C" void R__ZipForkPrepare();
+extern "C" void R__ZipForkParent();
+extern "C" void R__ZipForkChild();
+
 enum { kMAXZIPBUF = 0xffffff };
 
 #endif
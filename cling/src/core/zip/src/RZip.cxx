@@ -11,15 +11,28 @@
 #include "RZip.h"
 #include "Bits.h"
 //#include "ZipLZMA.h"
-//#include "ZipLZ4.h"
-//#include "ZipZSTD.h"
+#ifdef R__HAS_LZ4
+#include "ZipLZ4.h"
+#endif
+#ifdef R__HAS_ZSTD
+#include "ZipZSTD.h"
+#endif
 
 #include "zlib.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // The size of the ROOT block framing headers for compression:
 // - 3 bytes to identify the compression algorithm and version.
@@ -40,6 +53,7 @@ static void R__unzipZLIB(int *srcsize, unsigned char *src, int *tgtsize, unsigne
    R__ZipMode = 1 : ZLIB compression algorithm is used (default)
    R__ZipMode = 2 : LZMA compression algorithm is used
    R__ZipMode = 4 : LZ4  compression algorithm is used
+   R__ZipMode = 5 : ZSTD compression algorithm is used
    R__ZipMode = 0 or 3 : a very old compression algorithm is used
    (the very old algorithm is supported for backward compatibility)
    The LZMA algorithm requires the external XZ package be installed when linking
@@ -49,10 +63,17 @@ static void R__unzipZLIB(int *srcsize, unsigned char *src, int *tgtsize, unsigne
   The LZ4 algorithm requires the external LZ4 package to be installed when linking
   is done.  LZ4 typically has the worst compression ratios, but much faster decompression
   speeds - sometimes by an order of magnitude.
+
+  The ZSTD algorithm requires the external ZSTD package; it compresses about as
+  well as ZLIB, but decompresses considerably faster.
+
+  Algorithms that are not available in this build (LZMA, and LZ4 or ZSTD if the
+  libraries were not found) fall back to ZLIB when compressing; buffers that
+  were compressed with them elsewhere can not be read.
 */
-#ifdef R__HAS_DEFAULT_ZSTD
+#if defined(R__HAS_DEFAULT_ZSTD) && defined(R__HAS_ZSTD)
 CppyyLegacy::RCompressionSetting::EAlgorithm::EValues R__ZipMode = CppyyLegacy::RCompressionSetting::EAlgorithm::EValues::kZSTD;
-#elif R__HAS_DEFAULT_LZ4
+#elif defined(R__HAS_DEFAULT_LZ4) && defined(R__HAS_LZ4)
 CppyyLegacy::RCompressionSetting::EAlgorithm::EValues R__ZipMode = CppyyLegacy::RCompressionSetting::EAlgorithm::EValues::kLZ4;
 #else
 CppyyLegacy::RCompressionSetting::EAlgorithm::EValues R__ZipMode = CppyyLegacy::RCompressionSetting::EAlgorithm::EValues::kZLIB;
@@ -78,6 +99,8 @@ unsigned long R__crc32(unsigned long crc, const unsigned char* buf, unsigned int
 /*                      1 = zlib */
 /*                      2 = lzma */
 /*                      3 = old */
+/*                      4 = lz4 */
+/*                      5 = zstd */
 void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, CppyyLegacy::RCompressionSetting::EAlgorithm::EValues compressionAlgorithm)
 {
 
@@ -99,10 +122,19 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
   if (compressionAlgorithm == CppyyLegacy::RCompressionSetting::EAlgorithm::kOldCompressionAlgo ||
       compressionAlgorithm == CppyyLegacy::RCompressionSetting::EAlgorithm::kUseGlobal) {
      R__zipOld(cxlevel, srcsize, src, tgtsize, tgt, irep);
+#ifdef R__HAS_LZ4
+  } else if (compressionAlgorithm == CppyyLegacy::RCompressionSetting::EAlgorithm::kLZ4) {
+     R__zipLZ4(cxlevel, srcsize, src, tgtsize, tgt, irep);
+#endif
+#ifdef R__HAS_ZSTD
+  } else if (compressionAlgorithm == CppyyLegacy::RCompressionSetting::EAlgorithm::kZSTD) {
+     R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+#endif
   } else {
      // 1 is for ZLIB (which is the default), ZLIB is also used for any illegal
      // algorithm setting.  This was a poor historic choice, as poor code may result in
      // a surprising change in algorithm in a future version of ROOT.
+     // Algorithms that are not available in this build end up here as well.
      R__zipZLIB(cxlevel, srcsize, src, tgtsize, tgt, irep);
   }
 }
@@ -358,6 +390,29 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
       return;
    }
 
+   if (is_valid_header_lz4(src)) {
+#ifdef R__HAS_LZ4
+      R__unzipLZ4(srcsize, src, tgtsize, tgt, irep);
+#else
+      fprintf(stderr, "R__unzip: LZ4 compression is not supported by this build\n");
+#endif
+      return;
+   }
+
+   if (is_valid_header_zstd(src)) {
+#ifdef R__HAS_ZSTD
+      R__unzipZSTD(srcsize, src, tgtsize, tgt, irep);
+#else
+      fprintf(stderr, "R__unzip: ZSTD compression is not supported by this build\n");
+#endif
+      return;
+   }
+
+   if (is_valid_header_lzma(src)) {
+      fprintf(stderr, "R__unzip: LZMA compression is not supported by this build\n");
+      return;
+   }
+
    /* Old zlib format */
    if (R__Inflate(&ibufptr, &ibufcnt, &obufptr, &obufcnt)) {
       fprintf(stderr, "R__unzip: error during decompression\n");
@@ -408,3 +463,270 @@ void R__unzipZLIB(int *srcsize, unsigned char *src, int *tgtsize, unsigned char
      *irep = stream.total_out;
      return;
 }
+
+
+/* ===========================================================================
+   Block-parallel compression and decompression.
+
+   Buffers are split in chunks that are compressed independently, each with
+   its own header. This is the layout that has always been used for buffers
+   larger than kMAXZIPBUF, so readers that handle those (such as TKey) read
+   block-compressed buffers as well. Serially, chunks are at most kMAXZIPBUF
+   large, as before; with more than one thread, buffers of at least two
+   blocks are split in chunks of about kZipBlockSize, which trades a little
+   compression for parallelism. The chunks are processed on a pool of worker threads, with
+   the calling thread taking part; one buffer is processed at a time, other
+   callers meanwhile run serially on their own thread.
+*/
+static const int kZipBlockSize = 1 << 20;
+static const int kZipMaxThreads = 64;
+
+static std::atomic<int> R__ZipThreads{-1};       // -1: to be read from $CPPYY_ZIP_THREADS
+
+static int R__NormalizeZipThreads(int nthreads)
+{
+   if (nthreads == 0)
+      nthreads = (int)std::thread::hardware_concurrency();
+   if (nthreads < 1) nthreads = 1;
+   if (nthreads > kZipMaxThreads) nthreads = kZipMaxThreads;
+   return nthreads;
+}
+
+void R__SetZipThreads(int nthreads)
+{
+   R__ZipThreads = R__NormalizeZipThreads(nthreads);
+}
+
+int R__GetZipThreads()
+{
+   int nthreads = R__ZipThreads;
+   if (nthreads < 0) {
+      const char *env = getenv("CPPYY_ZIP_THREADS");
+      nthreads = R__NormalizeZipThreads(env ? atoi(env) : 1);
+      R__ZipThreads = nthreads;
+   }
+   return nthreads;
+}
+
+namespace {
+
+class RZipWorkers {
+public:
+   ~RZipWorkers() {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fStop = true;
+      }
+      fWake.notify_all();
+      for (auto &t : fThreads)
+         t.join();
+   }
+
+   // Run task(0) ... task(ntasks-1) on up to nthreads threads, incl. the caller.
+   void Run(int ntasks, int nthreads, const std::function<void(int)> &task) {
+      std::unique_lock<std::mutex> busy(fBusy, std::try_to_lock);
+      if (!busy.owns_lock() || nthreads <= 1 || ntasks <= 1) {
+         for (int i = 0; i < ntasks; ++i)
+            task(i);
+         return;
+      }
+
+      Job job{task, ntasks};
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         while ((int)fThreads.size() < nthreads - 1)
+            fThreads.emplace_back(&RZipWorkers::Work, this);
+         fJob = &job;
+         fJobSlots = nthreads - 1;
+      }
+      fWake.notify_all();
+
+      int ndone = job.Process();
+
+   // workers only start on a job when called up under the lock, and the job
+   // can not go out of scope before the ones that did are finished with it
+      std::unique_lock<std::mutex> lock(fMutex);
+      fJob = nullptr;
+      job.fDone += ndone;
+      fDone.wait(lock, [&job] { return job.fDone == job.fNTasks && job.fActive == 0; });
+   }
+
+   // Around fork(): wait for the job in flight, if any, and hold the locks, so
+   // that the child gets them in a consistent state. The threads of the pool
+   // are not duplicated into the child, which forgets them (they can not be
+   // joined there) and starts new ones when needed.
+   void ForkPrepare() {
+      fBusy.lock();
+      fMutex.lock();
+   }
+
+   void ForkRelease(bool child) {
+      if (child) {
+         new std::vector<std::thread>(std::move(fThreads));    // leaked on purpose
+         fThreads.clear();
+      }
+      fMutex.unlock();
+      fBusy.unlock();
+   }
+
+private:
+   struct Job {
+      Job(const std::function<void(int)> &task, int ntasks) : fTask(task), fNTasks(ntasks) {}
+      int Process() {
+         int ndone = 0;
+         for (int i; (i = fNext++) < fNTasks; ++ndone)
+            fTask(i);
+         return ndone;
+      }
+      const std::function<void(int)> &fTask;
+      const int fNTasks;
+      std::atomic<int> fNext{0};
+      int fDone = 0;          // under fMutex
+      int fActive = 0;        // id.
+   };
+
+   void Work() {
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (true) {
+         fWake.wait(lock, [this] { return fStop || (fJob && fJobSlots > 0); });
+         if (fStop) return;
+         Job *job = fJob;
+         --fJobSlots;
+         ++job->fActive;
+         lock.unlock();
+         int ndone = job->Process();
+         lock.lock();
+         job->fDone += ndone;
+         --job->fActive;
+         fDone.notify_all();
+      }
+   }
+
+   std::mutex fBusy;
+   std::mutex fMutex;
+   std::condition_variable fWake;
+   std::condition_variable fDone;
+   std::vector<std::thread> fThreads;
+   Job *fJob = nullptr;
+   int fJobSlots = 0;
+   bool fStop = false;
+};
+
+RZipWorkers &GetZipWorkers()
+{
+   static RZipWorkers workers;
+   return workers;
+}
+
+} // unnamed namespace
+
+void R__ZipForkPrepare()
+{
+   GetZipWorkers().ForkPrepare();
+}
+
+void R__ZipForkParent()
+{
+   GetZipWorkers().ForkRelease(false);
+}
+
+void R__ZipForkChild()
+{
+   GetZipWorkers().ForkRelease(true);
+}
+
+void R__zipMultipleBlocks(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep,
+                          CppyyLegacy::RCompressionSetting::EAlgorithm::EValues compressionAlgorithm, int nthreads)
+{
+   *irep = 0;
+   if (*srcsize <= 0)
+      return;
+
+   nthreads = nthreads < 0 ? R__GetZipThreads() : R__NormalizeZipThreads(nthreads);
+
+// the old algorithm keeps its compression level in a global
+   CppyyLegacy::RCompressionSetting::EAlgorithm::EValues algo = compressionAlgorithm;
+   if (algo == CppyyLegacy::RCompressionSetting::EAlgorithm::kUseGlobal)
+      algo = R__ZipMode;
+   if (algo == CppyyLegacy::RCompressionSetting::EAlgorithm::kOldCompressionAlgo ||
+       algo == CppyyLegacy::RCompressionSetting::EAlgorithm::kUseGlobal)
+      nthreads = 1;
+
+// evenly sized chunks, so that none is too small to be compressed
+   const bool parallel = nthreads > 1 && *srcsize >= 2*kZipBlockSize;
+   const int nblocks = parallel ? *srcsize/kZipBlockSize : 1 + (*srcsize - 1)/kMAXZIPBUF;
+   const int chunk = 1 + (*srcsize - 1)/nblocks;
+
+// each chunk may not grow beyond its input (plus header), as before
+   if (!parallel) {
+      int noutot = 0;
+      for (int i = 0; i < nblocks; ++i) {
+         int nin = std::min(chunk, *srcsize - i*chunk);
+         int bufmax = std::min(nin, *tgtsize - noutot - HDRSIZE);
+         int nout = 0;
+         if (bufmax > 0)
+            R__zipMultipleAlgorithm(cxlevel, &nin, src + (long)i*chunk, &bufmax, tgt + noutot, &nout, compressionAlgorithm);
+         if (nout == 0)
+            return;
+         noutot += nout;
+      }
+      *irep = noutot;
+      return;
+   }
+
+   std::vector<std::vector<char>> chunks(nblocks);
+   std::vector<int> nouts(nblocks, 0);
+   GetZipWorkers().Run(nblocks, nthreads, [&](int i) {
+      int nin = std::min(chunk, *srcsize - i*chunk);
+      int bufmax = nin;
+      chunks[i].resize(nin + HDRSIZE);
+      R__zipMultipleAlgorithm(cxlevel, &nin, src + (long)i*chunk, &bufmax, chunks[i].data(), &nouts[i], compressionAlgorithm);
+   });
+
+   int noutot = 0;
+   for (int i = 0; i < nblocks; ++i) {
+      if (nouts[i] == 0 || noutot + nouts[i] > *tgtsize)
+         return;
+      memcpy(tgt + noutot, chunks[i].data(), nouts[i]);
+      noutot += nouts[i];
+   }
+   *irep = noutot;
+}
+
+void R__unzipMultipleBlocks(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep, int nthreads)
+{
+   *irep = 0;
+
+// locate the chunks from their headers
+   std::vector<int> inoffs, outoffs, nins, nbufs;
+   int inpos = 0, outpos = 0;
+   while (outpos < *tgtsize) {
+      int nin = 0, nbuf = 0;
+      if (*srcsize - inpos < HDRSIZE || R__unzip_header(&nin, src + inpos, &nbuf) != 0)
+         return;
+      if (nbuf <= 0 || nin > *srcsize - inpos || nbuf > *tgtsize - outpos) {
+         fprintf(stderr, "R__unzipMultipleBlocks: inconsistent chunk sizes\n");
+         return;
+      }
+      inoffs.push_back(inpos);   nins.push_back(nin);
+      outoffs.push_back(outpos); nbufs.push_back(nbuf);
+      inpos += nin;
+      outpos += nbuf;
+   }
+
+   nthreads = nthreads < 0 ? R__GetZipThreads() : R__NormalizeZipThreads(nthreads);
+
+   const int nchunks = (int)inoffs.size();
+   std::vector<int> nouts(nchunks, 0);
+   GetZipWorkers().Run(nchunks, nthreads, [&](int i) {
+      R__unzip(&nins[i], src + inoffs[i], &nbufs[i], tgt + outoffs[i], &nouts[i]);
+   });
+
+   int noutot = 0;
+   for (int i = 0; i < nchunks; ++i) {
+      if (nouts[i] != nbufs[i])
+         return;
+      noutot += nouts[i];
+   }
+   *irep = noutot;
+}
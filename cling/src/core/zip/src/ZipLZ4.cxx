@@ -0,0 +1,185 @@
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipLZ4.h"
+
+#include "ROOT/RConfig.hxx"
+
+#include <lz4.h>
+#include <lz4hc.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+// The LZ4 block is preceded by the usual 9 byte header ('L', '4', the LZ4
+// major version, and the deflated and inflated sizes) and an 8 byte XXH64
+// checksum of the compressed data, in canonical (big endian) form; the
+// deflated size in the header includes the checksum. This is the same format
+// as written by ROOT, so that files can be exchanged.
+static const int kChecksumOffset = 2 + 1 + 3 + 3;
+static const int kChecksumSize = 8;
+static const int kHeaderSize = kChecksumOffset + kChecksumSize;
+
+namespace {
+
+// XXH64 (see https://github.com/Cyan4973/xxHash), as the checksum of the
+// format; liblz4 carries its own copy, but does not export it.
+const uint64_t kPrime1 = 11400714785074694791ULL;
+const uint64_t kPrime2 = 14029467366897019727ULL;
+const uint64_t kPrime3 =  1609587929392839161ULL;
+const uint64_t kPrime4 =  9650029242287828579ULL;
+const uint64_t kPrime5 =  2870177450012600261ULL;
+
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t Read64(const unsigned char *p)
+{
+   return (uint64_t)p[0]       | (uint64_t)p[1] <<  8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+          (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+inline uint32_t Read32(const unsigned char *p)
+{
+   return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+   acc += input * kPrime2;
+   return Rotl(acc, 31) * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t val)
+{
+   acc ^= Round(0, val);
+   return acc * kPrime1 + kPrime4;
+}
+
+uint64_t XXH64(const unsigned char *p, size_t len, uint64_t seed)
+{
+   const unsigned char *end = p + len;
+   uint64_t h;
+
+   if (len >= 32) {
+      uint64_t v1 = seed + kPrime1 + kPrime2, v2 = seed + kPrime2, v3 = seed, v4 = seed - kPrime1;
+      for (; p + 32 <= end; p += 32) {
+         v1 = Round(v1, Read64(p));
+         v2 = Round(v2, Read64(p + 8));
+         v3 = Round(v3, Read64(p + 16));
+         v4 = Round(v4, Read64(p + 24));
+      }
+      h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+      h = MergeRound(h, v1);
+      h = MergeRound(h, v2);
+      h = MergeRound(h, v3);
+      h = MergeRound(h, v4);
+   } else
+      h = seed + kPrime5;
+
+   h += (uint64_t)len;
+
+   for (; p + 8 <= end; p += 8) {
+      h ^= Round(0, Read64(p));
+      h = Rotl(h, 27) * kPrime1 + kPrime4;
+   }
+   if (p + 4 <= end) {
+      h ^= (uint64_t)Read32(p) * kPrime1;
+      h = Rotl(h, 23) * kPrime2 + kPrime3;
+      p += 4;
+   }
+   for (; p < end; ++p) {
+      h ^= (*p) * kPrime5;
+      h = Rotl(h, 11) * kPrime1;
+   }
+
+   h ^= h >> 33;
+   h *= kPrime2;
+   h ^= h >> 29;
+   h *= kPrime3;
+   h ^= h >> 32;
+   return h;
+}
+
+} // unnamed namespace
+
+void R__zipLZ4(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+   *irep = 0;
+   if (*tgtsize <= kHeaderSize)
+      return;
+
+   char *out = tgt + kHeaderSize;
+   int returnStatus;
+   if (cxlevel > 9)
+      cxlevel = 9;
+   if (cxlevel >= 4) {
+      returnStatus = LZ4_compress_HC(src, out, *srcsize, *tgtsize - kHeaderSize, cxlevel);
+   } else {
+      returnStatus = LZ4_compress_default(src, out, *srcsize, *tgtsize - kHeaderSize);
+   }
+
+   if (R__unlikely(returnStatus == 0)) { // LZ4 compression failed (or the target is too small)
+      return;
+   }
+
+   uint64_t checksum = XXH64((const unsigned char *)out, returnStatus, 0);
+   for (int i = 0; i < kChecksumSize; ++i)
+      tgt[kChecksumOffset + i] = (char)(checksum >> (8 * (kChecksumSize - 1 - i)));
+
+   tgt[0] = 'L';
+   tgt[1] = '4';
+   tgt[2] = LZ4_VERSION_MAJOR;
+
+   unsigned deflateSize = returnStatus + kChecksumSize;
+   unsigned inflateSize = *srcsize;
+   tgt[3] = (char)(deflateSize & 0xff);
+   tgt[4] = (char)((deflateSize >> 8) & 0xff);
+   tgt[5] = (char)((deflateSize >> 16) & 0xff);
+   tgt[6] = (char)(inflateSize & 0xff);
+   tgt[7] = (char)((inflateSize >> 8) & 0xff);
+   tgt[8] = (char)((inflateSize >> 16) & 0xff);
+
+   *irep = returnStatus + kHeaderSize;
+}
+
+void R__unzipLZ4(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   *irep = 0;
+   if (R__unlikely(src[0] != 'L' || src[1] != '4')) {
+      fprintf(stderr, "R__unzipLZ4: algorithm run against buffer with incorrect header (got %d%d; expected %d%d).\n",
+              src[0], src[1], 'L', '4');
+      return;
+   }
+   if (R__unlikely(src[2] != LZ4_VERSION_MAJOR)) {
+      fprintf(stderr, "R__unzipLZ4: incompatible LZ4 version (got %d; expected %d).\n", src[2], LZ4_VERSION_MAJOR);
+      return;
+   }
+   if (R__unlikely(*srcsize < kHeaderSize)) {
+      fprintf(stderr, "R__unzipLZ4: too small source\n");
+      return;
+   }
+
+   int inputBufferSize = *srcsize - kHeaderSize;
+
+   uint64_t checksumFromFile = 0;
+   for (int i = 0; i < kChecksumSize; ++i)
+      checksumFromFile = (checksumFromFile << 8) | src[kChecksumOffset + i];
+   if (R__unlikely(XXH64(src + kHeaderSize, inputBufferSize, 0) != checksumFromFile)) {
+      fprintf(stderr, "R__unzipLZ4: buffer corruption error!  Calculated checksum does not match the one stored in the file.\n");
+      return;
+   }
+
+   int returnStatus = LZ4_decompress_safe((char *)(&src[kHeaderSize]), (char *)(tgt), inputBufferSize, *tgtsize);
+   if (R__unlikely(returnStatus < 0)) {
+      fprintf(stderr, "R__unzipLZ4: error in decompression around byte %d out of maximum %d.\n", -returnStatus,
+              *tgtsize);
+      return;
+   }
+
+   *irep = returnStatus;
+}
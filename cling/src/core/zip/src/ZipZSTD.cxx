@@ -0,0 +1,94 @@
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipZSTD.h"
+
+#include "ROOT/RConfig.hxx"
+
+#include <zstd.h>
+
+#include <memory>
+#include <stdio.h>
+
+// The ZSTD frame is preceded by the usual 9 byte header ('Z', 'S', 1, and the
+// deflated and inflated sizes), as written by ROOT.
+static const int kHeaderSize = 9;
+
+namespace {
+
+// (de)compression contexts are large and expensive to set up, so keep one per
+// thread rather than creating one per buffer
+using CCtx_ptr = std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>;
+using DCtx_ptr = std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)>;
+
+ZSTD_CCtx *GetCCtx()
+{
+   thread_local CCtx_ptr gCtx{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+   return gCtx.get();
+}
+
+ZSTD_DCtx *GetDCtx()
+{
+   thread_local DCtx_ptr gCtx{ZSTD_createDCtx(), &ZSTD_freeDCtx};
+   return gCtx.get();
+}
+
+} // unnamed namespace
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+   *irep = 0;
+   if (*tgtsize <= kHeaderSize)
+      return;
+
+   ZSTD_CCtx *ctx = GetCCtx();
+   if (R__unlikely(!ctx))
+      return;
+
+   size_t retval = ZSTD_compressCCtx(ctx, &tgt[kHeaderSize], static_cast<size_t>(*tgtsize - kHeaderSize),
+                                     src, static_cast<size_t>(*srcsize), 2 * cxlevel);
+   if (R__unlikely(ZSTD_isError(retval))) { // includes a too small target
+      return;
+   }
+
+   size_t deflateSize = retval;
+   size_t inflateSize = static_cast<size_t>(*srcsize);
+   tgt[0] = 'Z';
+   tgt[1] = 'S';
+   tgt[2] = '\1';
+   tgt[3] = (char)(deflateSize & 0xff);
+   tgt[4] = (char)((deflateSize >> 8) & 0xff);
+   tgt[5] = (char)((deflateSize >> 16) & 0xff);
+   tgt[6] = (char)(inflateSize & 0xff);
+   tgt[7] = (char)((inflateSize >> 8) & 0xff);
+   tgt[8] = (char)((inflateSize >> 16) & 0xff);
+
+   *irep = static_cast<int>(retval + kHeaderSize);
+}
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   *irep = 0;
+   if (R__unlikely(*srcsize < kHeaderSize)) {
+      fprintf(stderr, "R__unzipZSTD: too small source\n");
+      return;
+   }
+
+   ZSTD_DCtx *ctx = GetDCtx();
+   if (R__unlikely(!ctx))
+      return;
+
+   size_t retval = ZSTD_decompressDCtx(ctx, (char *)tgt, static_cast<size_t>(*tgtsize),
+                                       (char *)&src[kHeaderSize], static_cast<size_t>(*srcsize - kHeaderSize));
+   if (R__unlikely(ZSTD_isError(retval))) {
+      fprintf(stderr, "R__unzipZSTD: error in decompression; error code %s\n", ZSTD_getErrorName(retval));
+      return;
+   }
+
+   *irep = static_cast<int>(retval);
+}
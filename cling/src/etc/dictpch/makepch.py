@@ -8,6 +8,10 @@
 # $2: cxxflags (optional; required if extra headers are supplied)
 # $3: extra headers to be included in the PCH (optional)
 #
+# With "--chain <base PCH>" as leading arguments, only the extra headers are
+# compiled, into a PCH layered on top of the given (standard) PCH; the result
+# then loads its base by itself.
+#
 # exit code 1 for invocation errors; else exit code of rootcling invocation.
 #
 # Copyright (c) 2014 Rene Brun and Fons Rademakers
@@ -25,6 +29,10 @@ import tempfile
 #-------------------------------------------------------------------------------
 def getArgs():
    argv = sys.argv
+   basePCHFileName = ""
+   if len(argv) > 2 and argv[1] == "--chain":
+      basePCHFileName = argv[2]
+      argv = argv[:1] + argv[3:]
    argc = len(argv)
    if argc < 2:
       print("ERROR: too few arguments specified!")
@@ -34,8 +42,8 @@ def getArgs():
       cxxflags = argv[2]
    extraHeadersList = ""
    if argc > 3:
-      extraHeadersList = argv[2:]
-   return pchFileName, cxxflags, extraHeadersList
+      extraHeadersList = argv[3:] if basePCHFileName else argv[2:]
+   return pchFileName, cxxflags, extraHeadersList, basePCHFileName
 
 #-------------------------------------------------------------------------------
 def getCppFlags(cppflagsFilename):
@@ -76,7 +84,10 @@ def makepch():
    alllinkdefsFilename = os.path.join(cfgdir,"allLinkDefs.h")
    cppflagsFilename = os.path.join(cfgdir,"allCppflags.txt")
 
-   pchFileName, extraCppflags, extraHeadersList = getArgs()
+   pchFileName, extraCppflags, extraHeadersList, basePCHFileName = getArgs()
+   if basePCHFileName and not extraHeadersList:
+      print("ERROR: no headers specified to layer on top of %s" % basePCHFileName)
+      sys.exit(1)
 
    rootbuildFlag=""
    loc1 = os.path.join(rootdir, allheadersFilename)
@@ -124,12 +135,18 @@ def makepch():
    except ValueError:   # "-isystem" not in list
       pass
 
+   if basePCHFileName:
+      cppFlagsList += ["-include-pch", os.path.abspath(basePCHFileName)]
+
    command.append("-cxxflags")
    command.append(" ".join(cppFlagsList))
 
-   command.append(allheadersFilename)
-   command += extraHeadersList
-   command.append(alllinkdefsFilename)
+   if basePCHFileName:
+      command += extraHeadersList
+   else:
+      command.append(allheadersFilename)
+      command += extraHeadersList
+      command.append(alllinkdefsFilename)
 
    if "VERBOSE" in os.environ:
       print(command)
@@ -0,0 +1,99 @@
+// Throughput of the byte swapping copies used by the TBufferFile fast-array
+// paths, in GB/s (of array data) per element size and direction.
+//
+// Standalone, as it only needs the kernels; from io/io:
+//
+//    c++ -std=c++14 -O2 -Isrc bench/bswap_bench.cxx src/TBufferSwapCopy.cxx -o bswap_bench
+//
+// The kernel is chosen as in the library; run with CPPYY_BSWAP_KERNEL=scalar
+// (or ssse3) for the baselines. Results are written as JSON to stdout.
+//
+// Options: --elements <n> (per array, default 1M), --repeat <n> (default 10).
+
+#include "TBufferSwapCopy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+using namespace CppyyLegacy::Internal;
+
+typedef void (*SwapCopy_t)(void *, const void *, size_t);
+
+struct Result {
+   std::string fName;
+   std::vector<double> fSamples;     // GB/s
+};
+
+volatile unsigned gSink = 0;
+
+Result Measure(const char *name, SwapCopy_t swapcopy, size_t size, size_t nelem, int repeat)
+{
+// separate source and target, as in reading from/writing to the buffer; the
+// source is offset by one byte, as array data in a buffer is not aligned
+   std::vector<char> src(nelem*size + 1), dst(nelem*size);
+   for (size_t i = 0; i < src.size(); ++i)
+      src[i] = (char)(i*31 + 7);
+
+   swapcopy(dst.data(), src.data() + 1, nelem);    // warmup (and page in)
+
+   Result r{name, {}};
+   for (int irep = 0; irep < repeat; ++irep) {
+      auto start = std::chrono::steady_clock::now();
+      swapcopy(dst.data(), src.data() + 1, nelem);
+      double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      r.fSamples.push_back(nelem*size/s/1e9);
+      gSink += (unsigned char)dst[nelem/2*size];
+   }
+   return r;
+}
+
+} // unnamed namespace
+
+int main(int argc, char **argv)
+{
+   size_t nelem = 1 << 20;
+   int repeat = 10;
+   for (int i = 1; i + 1 < argc; i += 2) {
+      if (strcmp(argv[i], "--elements") == 0)
+         nelem = std::max(strtoul(argv[i+1], nullptr, 10), 1ul);
+      else if (strcmp(argv[i], "--repeat") == 0)
+         repeat = std::max(atoi(argv[i+1]), 1);
+      else {
+         fprintf(stderr, "usage: %s [--elements <n>] [--repeat <n>]\n", argv[0]);
+         return 2;
+      }
+   }
+
+// the kernels are symmetric, so read and write differ only in which side of
+// the copy is the buffer; both are measured for the element types of the
+// fast-array methods that share a kernel
+   std::vector<Result> results;
+   results.push_back(Measure("Short_t",  &SwapCopy16, 2, nelem, repeat));
+   results.push_back(Measure("Int_t",    &SwapCopy32, 4, nelem, repeat));
+   results.push_back(Measure("Float_t",  &SwapCopy32, 4, nelem, repeat));
+   results.push_back(Measure("Long64_t", &SwapCopy64, 8, nelem, repeat));
+   results.push_back(Measure("Double_t", &SwapCopy64, 8, nelem, repeat));
+
+   printf("{\n  \"kernel\": \"%s\",\n  \"elements\": %zu,\n  \"results\": [", SwapCopyKernel(), nelem);
+   const char *sep = "\n";
+   for (auto &r : results) {
+      std::vector<double> s = r.fSamples;
+      std::sort(s.begin(), s.end());
+      double median = s.size() % 2 ? s[s.size()/2] : (s[s.size()/2-1] + s[s.size()/2])/2.;
+      printf("%s    {\"name\": \"bswap/%s\", \"unit\": \"GB/s\", \"samples\": %zu, "
+             "\"min\": %.2f, \"median\": %.2f, \"max\": %.2f}",
+             sep, r.fName.c_str(), s.size(), s.front(), median, s.back());
+      sep = ",\n";
+   }
+   printf("\n  ]\n}\n");
+
+   return 0;
+}
@@ -89,6 +89,7 @@ protected:
    Bool_t           fInitDone{kFALSE};        ///<!True if the file has been initialized
    Bool_t           fMustFlush{kTRUE};        ///<!True if the file buffers must be flushed
    Bool_t           fIsPcmFile{kFALSE};       ///<!True if the file is a ROOT pcm file.
+   Int_t            fCompressThreads{-1};     ///<!Threads for (de)compressing large keys (<0: global setting, 0: all cores)
    TFileOpenHandle *fAsyncHandle{nullptr};    ///<!For proper automatic cleanup
    EAsyncOpenStatus fAsyncOpenStatus{kAOSNotAsync}; ///<!Status of an asynchronous open request
    TUrl             fUrl;                     ///<!URL of file
@@ -176,6 +177,7 @@ public:
            Int_t       GetCompressionLevel() const;
            Int_t       GetCompressionSettings() const;
            Float_t     GetCompressionFactor();
+           Int_t       GetCompressionThreads() const { return fCompressThreads; }
    virtual Long64_t    GetEND() const { return fEND; }
    virtual Int_t       GetErrno() const;
    virtual void        ResetErrno() const;
@@ -226,6 +228,7 @@ public:
    virtual void        SetCompressionAlgorithm(Int_t algorithm = CppyyLegacy::RCompressionSetting::EAlgorithm::kUseGlobal);
    virtual void        SetCompressionLevel(Int_t level = CppyyLegacy::RCompressionSetting::ELevel::kUseMin);
    virtual void        SetCompressionSettings(Int_t settings = CppyyLegacy::RCompressionSetting::EDefaults::kUseCompiledDefault);
+           void        SetCompressionThreads(Int_t nthreads = -1) { fCompressThreads = nthreads; }
    virtual void        SetEND(Long64_t last) { fEND = last; }
    virtual void        SetOffset(Long64_t offset, ERelativeTo pos = kBeg);
    virtual void        SetOption(Option_t *option=">") { fOption = option; }
@@ -0,0 +1,204 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/**
+\file TBufferSwapCopy.cxx
+\ingroup IO
+
+Byte swapping copies of arrays, used by TBufferFile to convert between the
+(big endian) buffer format and little endian hosts.
+
+On x86_64 with gcc or clang, the vector kernels are compiled with target
+attributes, so that they do not require the whole library to be built for
+a newer architecture; the kernel is selected once, on first use, from what
+the CPU supports. Elsewhere, the scalar loop is used (which compilers can
+vectorize themselves for the baseline architecture).
+*/
+
+#include "TBufferSwapCopy.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__CUDACC__)
+#define R__SWAPCOPY_X86
+#include <immintrin.h>
+#endif
+
+
+namespace {
+
+#if defined(__GNUC__)
+inline uint16_t Bswap(uint16_t x) { return __builtin_bswap16(x); }
+inline uint32_t Bswap(uint32_t x) { return __builtin_bswap32(x); }
+inline uint64_t Bswap(uint64_t x) { return __builtin_bswap64(x); }
+#else
+inline uint16_t Bswap(uint16_t x) { return (uint16_t)((x >> 8) | (x << 8)); }
+inline uint32_t Bswap(uint32_t x)
+{
+   return ((x & 0xff000000u) >> 24) | ((x & 0x00ff0000u) >>  8) |
+          ((x & 0x0000ff00u) <<  8) | ((x & 0x000000ffu) << 24);
+}
+inline uint64_t Bswap(uint64_t x)
+{
+   return ((uint64_t)Bswap((uint32_t)x) << 32) | Bswap((uint32_t)(x >> 32));
+}
+#endif
+
+template <typename T>
+void SwapCopyScalar(void *to, const void *from, size_t n)
+{
+   const char *src = (const char *)from;
+   char *dst = (char *)to;
+   for (size_t i = 0; i < n; ++i) {
+      T v;
+      memcpy(&v, src + i*sizeof(T), sizeof(T));
+      v = Bswap(v);
+      memcpy(dst + i*sizeof(T), &v, sizeof(T));
+   }
+}
+
+#ifdef R__SWAPCOPY_X86
+// shuffle control that reverses the bytes within each element of size N
+template <size_t N, size_t W>
+struct SwapMask {
+   SwapMask() {
+      for (size_t b = 0; b < W; ++b)
+         fBytes[b] = (char)((b/N)*N + (N-1 - b%N));
+   }
+   alignas(W) char fBytes[W];
+};
+
+template <typename T>
+__attribute__((target("ssse3")))
+void SwapCopySSSE3(void *to, const void *from, size_t n)
+{
+   static const SwapMask<sizeof(T), 16> gMask;
+   const __m128i mask = _mm_load_si128((const __m128i *)gMask.fBytes);
+   const char *src = (const char *)from;
+   char *dst = (char *)to;
+   const size_t nbytes = n*sizeof(T);
+   size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+      _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(v, mask));
+   }
+   SwapCopyScalar<T>(dst + i, src + i, (nbytes - i)/sizeof(T));
+}
+
+template <typename T>
+__attribute__((target("avx2")))
+void SwapCopyAVX2(void *to, const void *from, size_t n)
+{
+// vpshufb shuffles within 128-bit lanes, which is fine as elements do not
+// straddle lanes; unrolled once to keep two loads in flight
+   static const SwapMask<sizeof(T), 32> gMask;
+   const __m256i mask = _mm256_load_si256((const __m256i *)gMask.fBytes);
+   const char *src = (const char *)from;
+   char *dst = (char *)to;
+   const size_t nbytes = n*sizeof(T);
+   size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m256i v0 = _mm256_loadu_si256((const __m256i *)(src + i));
+      __m256i v1 = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+      _mm256_storeu_si256((__m256i *)(dst + i),      _mm256_shuffle_epi8(v0, mask));
+      _mm256_storeu_si256((__m256i *)(dst + i + 32), _mm256_shuffle_epi8(v1, mask));
+   }
+   if (i + 32 <= nbytes) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+      _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(v, mask));
+      i += 32;
+   }
+   SwapCopySSSE3<T>(dst + i, src + i, (nbytes - i)/sizeof(T));
+}
+#endif
+
+typedef void (*SwapCopy_t)(void *, const void *, size_t);
+
+struct Kernels {
+   SwapCopy_t  f16;
+   SwapCopy_t  f32;
+   SwapCopy_t  f64;
+   const char *fName;
+};
+
+Kernels SelectKernels()
+{
+   Kernels k = {&SwapCopyScalar<uint16_t>, &SwapCopyScalar<uint32_t>, &SwapCopyScalar<uint64_t>, "scalar"};
+
+#ifdef R__SWAPCOPY_X86
+   __builtin_cpu_init();
+   bool ssse3 = __builtin_cpu_supports("ssse3");
+   bool avx2  = __builtin_cpu_supports("avx2");
+
+// allow selecting a lesser kernel, for comparisons
+   if (const char *env = getenv("CPPYY_BSWAP_KERNEL")) {
+      if (strcmp(env, "scalar") == 0)
+         ssse3 = avx2 = false;
+      else if (strcmp(env, "ssse3") == 0)
+         avx2 = false;
+   }
+
+   if (avx2)
+      k = {&SwapCopyAVX2<uint16_t>, &SwapCopyAVX2<uint32_t>, &SwapCopyAVX2<uint64_t>, "avx2"};
+   else if (ssse3)
+      k = {&SwapCopySSSE3<uint16_t>, &SwapCopySSSE3<uint32_t>, &SwapCopySSSE3<uint64_t>, "ssse3"};
+#endif
+
+   return k;
+}
+
+const Kernels &GetKernels()
+{
+   static const Kernels gKernels = SelectKernels();
+   return gKernels;
+}
+
+} // unnamed namespace
+
+
+namespace CppyyLegacy {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 2-byte elements from `from` to `to`, swapping the bytes of each.
+
+void SwapCopy16(void *to, const void *from, size_t n)
+{
+   GetKernels().f16(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4-byte elements from `from` to `to`, swapping the bytes of each.
+
+void SwapCopy32(void *to, const void *from, size_t n)
+{
+   GetKernels().f32(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 8-byte elements from `from` to `to`, swapping the bytes of each.
+
+void SwapCopy64(void *to, const void *from, size_t n)
+{
+   GetKernels().f64(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name of the selected kernel: "avx2", "ssse3", or "scalar".
+
+const char *SwapCopyKernel()
+{
+   return GetKernels().fName;
+}
+
+} // namespace Internal
+} // namespace CppyyLegacy
@@ -0,0 +1,42 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2019, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferSwapCopy
+#define ROOT_TBufferSwapCopy
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TBufferSwapCopy                                                      //
+//                                                                      //
+// Byte swapping copies of arrays of 2, 4 and 8 byte elements, for the  //
+// fast-array paths of TBufferFile on little endian hosts. The kernel   //
+// (AVX2, SSSE3 or scalar) is selected at run time from the features of //
+// the CPU, or with $CPPYY_BSWAP_KERNEL=avx2|ssse3|scalar.              //
+//                                                                      //
+// As with memcpy, n is the number of elements (not bytes), and the     //
+// ranges may not overlap; neither pointer needs to be aligned.         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+
+namespace CppyyLegacy {
+namespace Internal {
+
+   void SwapCopy16(void *to, const void *from, size_t n);
+   void SwapCopy32(void *to, const void *from, size_t n);
+   void SwapCopy64(void *to, const void *from, size_t n);
+
+   const char *SwapCopyKernel();    // name of the kernel in use
+
+} // namespace Internal
+} // namespace CppyyLegacy
+
+#endif
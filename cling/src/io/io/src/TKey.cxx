@@ -76,6 +76,12 @@ const ULong64_t kPidOffsetMask = 0xffffffffffffUL;
 #endif
 const UChar_t kPidOffsetShift = 48;
 
+// threads for (de)compressing large keys, per file (or the global setting)
+static Int_t GetCompressionThreads(TFile *file)
+{
+   return file ? file->GetCompressionThreads() : -1;
+}
+
 TString &gTDirectoryString() {
    TTHREAD_TLS_DECL_ARG(TString,gTDirectoryString,"CppyyLegacy::TDirectory");
    return gTDirectoryString;
@@ -236,7 +242,7 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
 
    Build(motherDir, obj->ClassName(), -1);
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf, noutot;
    fBufferRef = new TBufferFile(TBuffer::kWrite, bufsize);
    fBufferRef->SetParent(GetFile());
    fCycle     = fMotherDir->AppendKey(this);
@@ -255,24 +261,16 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
       Int_t buflen = TMath::Max(512,fKeylen + fObjlen + 9*nbuffers + 28); //add 28 bytes in case object is placed in a deleted gap
       fBuffer = new char[buflen];
       char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+      Int_t objlen = fObjlen, room = buflen - fKeylen;
+      R__zipMultipleBlocks(cxlevel, &objlen, objbuf, &room, &fBuffer[fKeylen], &noutot, cxAlgorithm,
+                           GetCompressionThreads(GetFile()));
+      if (noutot == 0 || noutot >= fObjlen) { //this happens when the buffer cannot be compressed
+         delete [] fBuffer;
+         fBuffer = fBufferRef->Buffer();
+         Create(fObjlen);
+         fBufferRef->SetBufferOffset(0);
+         Streamer(*fBufferRef);         //write key itself again
+         return;
       }
       Create(noutot);
       fBufferRef->SetBufferOffset(0);
@@ -332,7 +330,7 @@ TKey::TKey(const void *obj, const TClass *cl, const char *name, Int_t bufsize, T
    Streamer(*fBufferRef);         //write key itself
    fKeylen    = fBufferRef->Length();
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf, noutot;
 
    fBufferRef->MapObject(actualStart,clActual);         //register obj in map in case of self reference
    clActual->Streamer((void*)actualStart, *fBufferRef); //write object
@@ -346,24 +344,16 @@ TKey::TKey(const void *obj, const TClass *cl, const char *name, Int_t bufsize, T
       Int_t buflen = TMath::Max(512,fKeylen + fObjlen + 9*nbuffers + 28); //add 28 bytes in case object is placed in a deleted gap
       fBuffer = new char[buflen];
       char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+      Int_t objlen = fObjlen, room = buflen - fKeylen;
+      R__zipMultipleBlocks(cxlevel, &objlen, objbuf, &room, &fBuffer[fKeylen], &noutot, cxAlgorithm,
+                           GetCompressionThreads(GetFile()));
+      if (noutot == 0 || noutot >= fObjlen) { //this happens when the buffer cannot be compressed
+         delete [] fBuffer;
+         fBuffer = fBufferRef->Buffer();
+         Create(fObjlen);
+         fBufferRef->SetBufferOffset(0);
+         Streamer(*fBufferRef);         //write key itself again
+         return;
       }
       Create(noutot);
       fBufferRef->SetBufferOffset(0);
@@ -734,20 +724,9 @@ TObject *TKey::ReadObj()
       fBufferRef->MapObject(pobj,cl);  //register obj in map to handle self reference
 
    if (fObjlen > fNbytes-fKeylen) {
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nin = fNbytes - fKeylen, nbuf = fObjlen, nout = 0;
+      R__unzipMultipleBlocks(&nin, (UChar_t *)&fBuffer[fKeylen], &nbuf,
+                             (UChar_t *)fBufferRef->Buffer() + fKeylen, &nout, GetCompressionThreads(GetFile()));
       if (nout) {
          tobj->Streamer(*fBufferRef); //does not work with example 2 above
          delete [] fBuffer;
@@ -855,20 +834,9 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
       fBufferRef->MapObject(pobj,cl);  //register obj in map to handle self reference
 
    if (fObjlen > fNbytes-fKeylen) {
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nin = fNbytes - fKeylen, nbuf = fObjlen, nout = 0;
+      R__unzipMultipleBlocks(&nin, (UChar_t *)&fBuffer[fKeylen], &nbuf,
+                             (UChar_t *)fBufferRef->Buffer() + fKeylen, &nout, GetCompressionThreads(GetFile()));
       if (nout) {
          tobj->Streamer(*fBufferRef); //does not work with example 2 above
       } else {
@@ -981,20 +949,9 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
       fBufferRef->MapObject(pobj,cl);  //register obj in map to handle self reference
 
    if (fObjlen > fNbytes-fKeylen) {
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nin = fNbytes - fKeylen, nbuf = fObjlen, nout = 0;
+      R__unzipMultipleBlocks(&nin, (UChar_t *)&fBuffer[fKeylen], &nbuf,
+                             (UChar_t *)fBufferRef->Buffer() + fKeylen, &nout, GetCompressionThreads(GetFile()));
       if (nout) {
          cl->Streamer((void*)pobj, *fBufferRef, clOnfile);    //read object
          delete [] fBuffer;
@@ -1061,20 +1018,9 @@ Int_t TKey::Read(TObject *obj)
    }
    fBufferRef->SetBufferOffset(fKeylen);
    if (fObjlen > fNbytes-fKeylen) {
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nin = fNbytes - fKeylen, nbuf = fObjlen, nout = 0;
+      R__unzipMultipleBlocks(&nin, (UChar_t *)&fBuffer[fKeylen], &nbuf,
+                             (UChar_t *)fBufferRef->Buffer() + fKeylen, &nout, GetCompressionThreads(GetFile()));
       if (nout) obj->Streamer(*fBufferRef);
       delete [] fBuffer;
    } else {
@@ -16,6 +16,7 @@
 #include "TEnum.h"
 #include "TError.h"
 #include "TFile.h"
+#include "TObjString.h"
 #include "TProtoClass.h"
 #include "TROOT.h"
 #include "TStreamerInfo.h"
@@ -25,6 +26,7 @@
 using namespace CppyyLegacy;
 
 std::string gPCMFilename;
+int gPCMCompression = RCompressionSetting::EDefaults::kUseCompiledDefault;
 std::vector<std::string> gClassesToStore;
 std::vector<std::string> gTypedefsToStore;
 std::vector<std::string> gEnumsToStore;
@@ -36,6 +38,12 @@ void InitializeStreamerInfoROOTFile(const char *filename)
    gPCMFilename = filename;
 }
 
+extern "C"
+void SetStreamerInfoROOTFileCompression(int settings)
+{
+   gPCMCompression = settings;
+}
+
 extern "C"
 void AddStreamerInfoToROOTFile(const char *normName)
 {
@@ -125,7 +133,7 @@ bool CloseStreamerInfoROOTFile(bool writeEmptyRootPCM)
    TVirtualStreamerInfo::SetFactory(new TStreamerInfo());
 
    // Don't use TFile::Open(); we don't need plugins.
-   TFile dictFile((gPCMFilename + "?filetype=pcm").c_str(), "RECREATE");
+   TFile dictFile((gPCMFilename + "?filetype=pcm").c_str(), "RECREATE", "", gPCMCompression);
 
    // Reset the content of the pcm
    if (writeEmptyRootPCM) {
@@ -213,6 +221,12 @@ bool CloseStreamerInfoROOTFile(bool writeEmptyRootPCM)
    if (dictFile.IsZombie())
       return false;
 // Instead of plugins:
+   // The names allow the proto classes to be deserialized lazily, on first use.
+   TObjArray protoClassNames(protoClasses.GetEntriesFast());
+   protoClassNames.SetOwner(kTRUE);
+   for (auto proto : protoClasses)
+      protoClassNames.AddLast(new TObjString(proto->GetName()));
+   protoClassNames.Write("__ProtoClassNames", TObject::kSingleKey);
    protoClasses.Write("__ProtoClasses", TObject::kSingleKey);
    protoClasses.Delete();
    typedefs.Write("__Typedefs", TObject::kSingleKey);
@@ -20,6 +20,7 @@ using namespace CppyyLegacy;
 extern "C" {
    R__DLLEXPORT void usedToIdentifyRootClingByDlSym() {}
    void InitializeStreamerInfoROOTFile(const char *filename);
+   void SetStreamerInfoROOTFileCompression(int settings);
    void AddStreamerInfoToROOTFile(const char *normName);
    void AddTypedefToROOTFile(const char *tdname);
    void AddEnumToROOTFile(const char *tdname);
@@ -43,6 +44,7 @@ int main(int argc, char **argv)
    config.fTROOT__GetEtcDir = &TROOT__GetEtcDir;
    config.fTCling__GetInterpreter = &TCling__GetInterpreter;
    config.fInitializeStreamerInfoROOTFile = &InitializeStreamerInfoROOTFile;
+   config.fSetStreamerInfoROOTFileCompression = &SetStreamerInfoROOTFileCompression;
    config.fAddStreamerInfoToROOTFile = &AddStreamerInfoToROOTFile;
    config.fAddTypedefToROOTFile = &AddTypedefToROOTFile;
    config.fAddEnumToROOTFile = &AddEnumToROOTFile;
@@ -0,0 +1,1024 @@
+// Standalone benchmarks of the C API of libcppyy_backend.
+//
+// The backend is loaded with dlopen() (from $CPPYY_BACKEND_LIBRARY, or --lib),
+// so that the cost of starting the interpreter can be measured, too. The
+// results are written as JSON, to stdout or to the file given with --out, with
+// per-operation timings in nanoseconds (min/median/mean/max over the samples);
+// benchmarks with names ending in "kB" report private memory in kB instead.
+//
+// Build with "python setup.py build_bench".
+
+// Bindings
+#include "capi.h"
+
+// Standard
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dlfcn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace {
+
+// C API entry points, resolved from the backend after loading it
+#define CPPYY_BENCH_APIS(X)                                                   \
+    X(cppyy_compile)                                                          \
+    X(cppyy_get_scope)                                                        \
+    X(cppyy_resolve_name)                                                     \
+    X(cppyy_method_indices_from_name)                                         \
+    X(cppyy_get_method)                                                       \
+    X(cppyy_num_methods)                                                      \
+    X(cppyy_method_name)                                                      \
+    X(cppyy_method_result_type)                                               \
+    X(cppyy_method_num_args)                                                  \
+    X(cppyy_method_arg_name)                                                  \
+    X(cppyy_method_arg_type)                                                  \
+    X(cppyy_method_arg_default)                                               \
+    X(cppyy_method_signature)                                                 \
+    X(cppyy_num_datamembers)                                                  \
+    X(cppyy_datamember_name)                                                  \
+    X(cppyy_datamember_type)                                                  \
+    X(cppyy_datamember_offset)                                                \
+    X(cppyy_num_bases)                                                        \
+    X(cppyy_base_name)                                                        \
+    X(cppyy_describe_scope)                                                   \
+    X(cppyy_size_of_klass)                                                    \
+    X(cppyy_is_abstract)                                                      \
+    X(cppyy_is_enum)                                                          \
+    X(cppyy_get_all_cpp_names_packed)                                         \
+    X(cppyy_call_i)                                                           \
+    X(cppyy_call_i_noexcept)                                                  \
+    X(cppyy_call_i_batch)                                                     \
+    X(cppyy_constructor)                                                      \
+    X(cppyy_destruct)                                                         \
+    X(cppyy_prepare_wrappers)                                                 \
+    X(cppyy_wait_for_wrappers)                                                \
+    X(cppyy_allocate_function_args)                                           \
+    X(cppyy_deallocate_function_args)                                         \
+    X(cppyy_function_arg_sizeof)                                              \
+    X(cppyy_function_arg_typeoffset)                                          \
+    X(cppyy_instrument_snapshot)                                              \
+    X(cppyy_preload)                                                          \
+    X(cppyy_serialize)                                                        \
+    X(cppyy_deserialize)                                                      \
+    X(cppyy_free)
+
+#define CPPYY_BENCH_DECLARE(name) decltype(&::name) p_##name = nullptr;
+CPPYY_BENCH_APIS(CPPYY_BENCH_DECLARE)
+#undef CPPYY_BENCH_DECLARE
+
+struct Options {
+    std::string fLib;
+    std::string fOut;
+    std::string fFilter;
+    int         fRepeat     = 5;
+    size_t      fIterations = 100000;
+    size_t      fClasses    = 2000;
+    int         fThreads    = (int)std::min(std::max(std::thread::hardware_concurrency(), 2u), 8u);
+};
+
+struct Result {
+    std::string fName;
+    size_t      fIterations;
+    std::vector<double> fSamples;     // ns per operation, unless noted
+    std::string fUnit = "ns";
+};
+
+std::vector<Result> gResults;
+volatile long long gSink = 0;         // keeps results alive
+
+typedef std::chrono::steady_clock clock_t_;
+
+inline double elapsed_ns(clock_t_::time_point start, clock_t_::time_point stop)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+}
+
+bool selected(const Options& opts, const std::string& name)
+{
+    return opts.fFilter.empty() || name.find(opts.fFilter) != std::string::npos;
+}
+
+// for skipping the setup of a whole group of benchmarks
+bool any_selected(const Options& opts, std::initializer_list<const char*> names)
+{
+    for (auto name : names) {
+        if (selected(opts, name))
+            return true;
+    }
+    return false;
+}
+
+// steady-state: time batches of <iterations> calls, one sample per repeat
+template<typename F>
+void bench(const Options& opts, const std::string& name, size_t iterations, F op)
+{
+    if (!selected(opts, name))
+        return;
+
+    for (size_t i = 0; i < iterations/10+1; ++i)   // warmup
+        op(i);
+
+    Result r{name, iterations, {}};
+    for (int irep = 0; irep < opts.fRepeat; ++irep) {
+        auto start = clock_t_::now();
+        for (size_t i = 0; i < iterations; ++i)
+            op(i);
+        r.fSamples.push_back(elapsed_ns(start, clock_t_::now())/iterations);
+    }
+    gResults.push_back(r);
+}
+
+// one-shot: time each of <count> distinct operations (e.g. first calls)
+template<typename F>
+void bench_once(const Options& opts, const std::string& name, size_t count, F op)
+{
+    if (!selected(opts, name))
+        return;
+
+    Result r{name, 1, {}};
+    for (size_t i = 0; i < count; ++i) {
+        auto start = clock_t_::now();
+        op(i);
+        r.fSamples.push_back(elapsed_ns(start, clock_t_::now()));
+    }
+    gResults.push_back(r);
+}
+
+void add_sample(const std::string& name, size_t iterations, double ns_per_op)
+{
+    gResults.push_back(Result{name, iterations, {ns_per_op}});
+}
+
+
+//- helpers for driving the C API --------------------------------------------
+cppyy_method_t find_method(cppyy_scope_t scope, const char* name, int nargs = -1)
+{
+    cppyy_method_t result = 0;
+    cppyy_index_t* indices = p_cppyy_method_indices_from_name(scope, name);
+    if (!indices)
+        return result;
+    for (cppyy_index_t* idx = indices; *idx != (cppyy_index_t)-1; ++idx) {
+        cppyy_method_t m = p_cppyy_get_method(scope, *idx);
+        if (m && (nargs < 0 || p_cppyy_method_num_args(m) == nargs)) {
+            result = m;
+            break;
+        }
+    }
+    p_cppyy_free(indices);
+    return result;
+}
+
+// argument buffer of int arguments, using the layout reported by the backend
+struct IntArgs {
+    IntArgs(int nargs) : fNArgs(nargs), fArgs(p_cppyy_allocate_function_args(nargs)) {
+        size_t sz = p_cppyy_function_arg_sizeof(), tc = p_cppyy_function_arg_typeoffset();
+        for (int i = 0; i < nargs; ++i) {
+            char* arg = (char*)fArgs + i*sz;
+            *(int*)arg = i+1;          // value union at offset 0
+            arg[tc] = 'i';
+        }
+    }
+    ~IntArgs() { p_cppyy_deallocate_function_args(fArgs); }
+    int   fNArgs;
+    void* fArgs;
+};
+
+inline void free_str(char* s)
+{
+    gSink += (long long)(s ? s[0] : 0);
+    p_cppyy_free(s);
+}
+
+std::string int_params(int nargs)
+{
+    std::string params, body = "0";
+    for (int i = 0; i < nargs; ++i) {
+        params += (i ? ", int a" : "int a") + std::to_string(i);
+        body += "+a" + std::to_string(i);
+    }
+    return "(" + params + ") { return " + body + "; }";
+}
+
+
+//- benchmarks ---------------------------------------------------------------
+void bench_scopes(const Options& opts)
+{
+    if (!any_selected(opts, {"scope/hit", "scope/miss_cached", "scope/miss_first"}))
+        return;
+
+    bench(opts, "scope/hit", opts.fIterations, [](size_t) {
+        gSink += (long long)p_cppyy_get_scope("cppyy_bench::Obj");
+    });
+    bench(opts, "scope/miss_cached", opts.fIterations, [](size_t) {
+        gSink += (long long)p_cppyy_get_scope("cppyy_bench::NoSuchClass");
+    });
+    bench_once(opts, "scope/miss_first", std::min(opts.fIterations, (size_t)200), [](size_t i) {
+        gSink += (long long)p_cppyy_get_scope(("cppyy_bench::NoSuchClass" + std::to_string(i)).c_str());
+    });
+}
+
+void bench_jit(const Options& opts)
+{
+    if (!any_selected(opts, {"jit/first_call", "jit/repeat_call", "jit/prepared"}))
+        return;
+
+// unique names per process, so that no wrappers exist yet
+    const size_t nfuncs = 100;
+    std::string ns = "cppyy_bench_jit" + std::to_string((long)getpid());
+    std::string code = "namespace " + ns + " {\n";
+    for (size_t i = 0; i < nfuncs; ++i) {
+        code += "int single" + std::to_string(i) + int_params(1) + "\n";
+        code += "int batch" + std::to_string(i) + int_params(1) + "\n";
+    }
+    code += "}";
+    p_cppyy_compile(code.c_str());
+    cppyy_scope_t scope = p_cppyy_get_scope(ns.c_str());
+
+    IntArgs args(1);
+    auto call_single = [&](size_t i) {
+        cppyy_method_t m = find_method(scope, ("single" + std::to_string(i)).c_str());
+        gSink += p_cppyy_call_i(m, nullptr, 1, args.fArgs);
+    };
+    bench_once(opts, "jit/first_call", nfuncs, call_single);
+
+// the same calls with the wrappers in place: the difference with first_call is
+// the wrapper generation and compilation time that reusing compiled code saves
+    if (selected(opts, "jit/repeat_call")) {
+        if (!selected(opts, "jit/first_call")) {
+            for (size_t i = 0; i < nfuncs; ++i)
+                call_single(i);
+        }
+        bench_once(opts, "jit/repeat_call", nfuncs, call_single);
+    }
+
+    if (selected(opts, "jit/prepared")) {
+        std::vector<cppyy_method_t> methods;
+        for (size_t i = 0; i < nfuncs; ++i)
+            methods.push_back(find_method(scope, ("batch" + std::to_string(i)).c_str()));
+        auto start = clock_t_::now();
+        p_cppyy_prepare_wrappers(methods.data(), (int)methods.size());
+        p_cppyy_wait_for_wrappers();
+        for (auto m : methods)
+            gSink += p_cppyy_call_i(m, nullptr, 1, args.fArgs);
+        add_sample("jit/prepared", nfuncs, elapsed_ns(start, clock_t_::now())/nfuncs);
+    }
+}
+
+void bench_calls(const Options& opts)
+{
+    if (!any_selected(opts, {"call/i0", "call/i1", "call/i8", "call/i16", "call/i1_noexcept", "call/i1_batch"}))
+        return;
+
+    cppyy_scope_t scope = p_cppyy_get_scope("cppyy_bench");
+    for (int nargs : {0, 1, 8, 16}) {
+        cppyy_method_t m = find_method(scope, ("f" + std::to_string(nargs)).c_str());
+        IntArgs args(nargs);
+        bench(opts, "call/i" + std::to_string(nargs), opts.fIterations, [&](size_t) {
+            gSink += p_cppyy_call_i(m, nullptr, nargs, args.fArgs);
+        });
+    }
+
+    cppyy_method_t mne = find_method(scope, "fn1");
+    IntArgs args(1);
+    bench(opts, "call/i1_noexcept", opts.fIterations, [&](size_t) {
+        gSink += p_cppyy_call_i_noexcept(mne, nullptr, 1, args.fArgs);
+    });
+
+    if (selected(opts, "call/i1_batch")) {
+        const size_t nrows = 1024;
+        std::vector<int> column(nrows), out(nrows);
+        for (size_t i = 0; i < nrows; ++i) column[i] = (int)i;
+        void* columns[] = {column.data()};
+        size_t strides[] = {sizeof(int)};
+        cppyy_method_t m = find_method(scope, "f1");
+        bench(opts, "call/i1_batch", std::max(opts.fIterations/nrows, (size_t)1), [&](size_t) {
+            gSink += p_cppyy_call_i_batch(m, nullptr, 1, columns, strides, nrows, out.data());
+        });
+    // report per row
+        gResults.back().fIterations *= nrows;
+        for (auto& s : gResults.back().fSamples) s /= nrows;
+    }
+}
+
+void bench_objects(const Options& opts)
+{
+    if (!any_selected(opts, {"object/ctor_dtor", "object/ctor1_dtor", "object/get_method"}))
+        return;
+
+    cppyy_scope_t klass = p_cppyy_get_scope("cppyy_bench::Obj");
+    cppyy_method_t ctor0 = find_method(klass, "Obj", 0);
+    cppyy_method_t ctor1 = find_method(klass, "Obj", 1);
+    IntArgs args(1);
+
+    bench(opts, "object/ctor_dtor", opts.fIterations, [&](size_t) {
+        cppyy_object_t obj = p_cppyy_constructor(ctor0, klass, 0, nullptr);
+        p_cppyy_destruct(klass, obj);
+    });
+    bench(opts, "object/ctor1_dtor", opts.fIterations, [&](size_t) {
+        cppyy_object_t obj = p_cppyy_constructor(ctor1, klass, 1, args.fArgs);
+        p_cppyy_destruct(klass, obj);
+    });
+    bench(opts, "object/get_method", opts.fIterations, [&](size_t) {
+        gSink += (long long)p_cppyy_get_method(klass, 0);
+    });
+}
+
+void bench_overloads(const Options& opts)
+{
+    if (!any_selected(opts, {"overload/signatures", "overload/arg_types"}))
+        return;
+
+// per pass over all overloads, as done when resolving a call
+    cppyy_scope_t klass = p_cppyy_get_scope("cppyy_bench::Over");
+    std::vector<cppyy_method_t> overloads;
+    cppyy_index_t* indices = p_cppyy_method_indices_from_name(klass, "f");
+    for (cppyy_index_t* idx = indices; idx && *idx != (cppyy_index_t)-1; ++idx)
+        overloads.push_back(p_cppyy_get_method(klass, *idx));
+    p_cppyy_free(indices);
+
+    bench(opts, "overload/signatures", opts.fIterations/100+1, [&](size_t) {
+        for (auto m : overloads)
+            free_str(p_cppyy_method_signature(m, 0));
+    });
+    bench(opts, "overload/arg_types", opts.fIterations/100+1, [&](size_t) {
+        for (auto m : overloads) {
+            int nargs = p_cppyy_method_num_args(m);
+            for (int iarg = 0; iarg < nargs; ++iarg)
+                free_str(p_cppyy_method_arg_type(m, iarg));
+            free_str(p_cppyy_method_result_type(m));
+        }
+    });
+}
+
+std::string generated_classes(const std::string& ns, size_t nclasses)
+{
+    std::string code = "namespace " + ns + " {\n";
+    for (size_t i = 0; i < nclasses; ++i) {
+        std::string c = "C" + std::to_string(i);
+        code += "struct " + c + (i ? " : public C" + std::to_string(i-1) : std::string{}) + " {\n"
+                "    " + c + "() {}\n"
+                "    " + c + "(int a, double b = 1.) : m0(a), m1(b) {}\n"
+                "    int f0(int a, double b = 2.) const { return a + (int)b; }\n"
+                "    void f1(const std::string& s, int* p = nullptr) {}\n"
+                "    static long s0(long a) { return a; }\n"
+                "    enum E { kA, kB, kC };\n"
+                "    int m0 = 0; double m1 = 0.; static const int sm = " + std::to_string(i) + ";\n"
+                "};\n";
+    }
+    return code + "}";
+}
+
+void bench_reflection(const Options& opts)
+{
+    if (!any_selected(opts, {"reflect/per_item", "reflect/describe"}))
+        return;
+
+// same classes in two namespaces, so that both variants see cold classes
+    p_cppyy_compile("#include <string>");
+    p_cppyy_compile(generated_classes("cppyy_bench_gen_a", opts.fClasses).c_str());
+    p_cppyy_compile(generated_classes("cppyy_bench_gen_b", opts.fClasses).c_str());
+
+    bench_once(opts, "reflect/per_item", opts.fClasses, [](size_t i) {
+        cppyy_scope_t scope = p_cppyy_get_scope(("cppyy_bench_gen_a::C" + std::to_string(i)).c_str());
+        int nbases = p_cppyy_num_bases(scope);
+        for (int ibase = 0; ibase < nbases; ++ibase)
+            free_str(p_cppyy_base_name(scope, ibase));
+        int nmethods = p_cppyy_num_methods(scope);
+        for (int imeth = 0; imeth < nmethods; ++imeth) {
+            cppyy_method_t m = p_cppyy_get_method(scope, imeth);
+            free_str(p_cppyy_method_name(m));
+            free_str(p_cppyy_method_result_type(m));
+            int nargs = p_cppyy_method_num_args(m);
+            for (int iarg = 0; iarg < nargs; ++iarg) {
+                free_str(p_cppyy_method_arg_name(m, iarg));
+                free_str(p_cppyy_method_arg_type(m, iarg));
+                free_str(p_cppyy_method_arg_default(m, iarg));
+            }
+        }
+        int ndata = p_cppyy_num_datamembers(scope);
+        for (int idata = 0; idata < ndata; ++idata) {
+            free_str(p_cppyy_datamember_name(scope, idata));
+            free_str(p_cppyy_datamember_type(scope, idata));
+            gSink += p_cppyy_datamember_offset(scope, idata);
+        }
+    });
+
+    bench_once(opts, "reflect/describe", opts.fClasses, [](size_t i) {
+        cppyy_scope_t scope = p_cppyy_get_scope(("cppyy_bench_gen_b::C" + std::to_string(i)).c_str());
+        cppyy_scope_desc_t* desc = p_cppyy_describe_scope(scope);
+        gSink += desc ? desc->nmethods : 0;
+        p_cppyy_free(desc);
+    });
+}
+
+
+void bench_names(const Options& opts)
+{
+// listing of the global namespace (dir(cppyy.gbl)): the first listing builds
+// the index, later ones only apply declarations made in between
+    bench_once(opts, "names/global_first", 1, [](size_t) {
+        size_t count = 0;
+        p_cppyy_free(p_cppyy_get_all_cpp_names_packed(p_cppyy_get_scope(""), &count));
+        gSink += count;
+    });
+
+    size_t ideclare = 0;
+    bench(opts, "names/global_after_declare", opts.fIterations/1000+1, [&ideclare](size_t) {
+        p_cppyy_compile(("namespace cppyy_bench_names { int f" + std::to_string(ideclare++) + "(); }").c_str());
+        size_t count = 0;
+        p_cppyy_free(p_cppyy_get_all_cpp_names_packed(p_cppyy_get_scope(""), &count));
+        gSink += count;
+    });
+
+// id. for std and a user namespace, with declarations in the global scope, std
+// and the namespace in between; run with CPPYY_VERIFY_NAME_INDEX=1 to have the
+// backend check each incremental result against a rebuild from scratch
+    for (const char* ns : {"std", "cppyy_bench_names"}) {
+        std::string name = std::string("names/") + ns + "_after_declare";
+        bench(opts, name, opts.fIterations/1000+1, [&ideclare, ns](size_t) {
+            std::string n = std::to_string(ideclare++);
+            p_cppyy_compile(("class cppyy_bench_names_C" + n + " {};\n"
+                             "namespace std { int cppyy_bench_names_f" + n + "(); }\n"
+                             "namespace cppyy_bench_names { class C" + n + " {}; }").c_str());
+            size_t count = 0;
+            p_cppyy_free(p_cppyy_get_all_cpp_names_packed(p_cppyy_get_scope(ns), &count));
+            gSink += count;
+        });
+    }
+}
+
+void bench_resolve(const Options& opts)
+{
+    const char* names[] = {"names/resolve_first", "names/resolve_class", "names/resolve_typedef"};
+    if (!any_selected(opts, {names[0], names[1], names[2]}))
+        return;
+
+// name resolution on a large header: <classes> classes, each with two levels
+// of typedefs, in a single namespace; first resolutions (cold) over distinct
+// typedefs, then repeated (memoized) ones over classes and typedefs
+    const size_t nclasses = opts.fClasses;
+    std::string code = "namespace cppyy_bench_resolve {\n";
+    for (size_t i = 0; i < nclasses; ++i) {
+        std::string n = std::to_string(i);
+        code += "struct C" + n + " { int m; };\n"
+                "typedef C" + n + " T" + n + ";\n"
+                "typedef const T" + n + "* P" + n + ";\n";
+    }
+    if (!p_cppyy_compile((code + "}").c_str())) {
+        fprintf(stderr, "failed to compile the name resolution benchmark code\n");
+        return;
+    }
+
+    auto name_of = [](const char* kind, size_t i) {
+        return "cppyy_bench_resolve::" + std::string(kind) + std::to_string(i);
+    };
+    std::vector<std::string> classes, typedefs;
+    for (size_t i = 0; i < nclasses; ++i) {
+        classes.push_back(name_of("C", i));
+        typedefs.push_back(name_of(i % 2 ? "P" : "T", i));
+    }
+
+    bench_once(opts, names[0], nclasses, [&name_of](size_t i) {
+        free_str(p_cppyy_resolve_name(name_of(i % 2 ? "T" : "P", i).c_str()));
+    });
+    bench(opts, names[1], opts.fIterations, [&classes](size_t i) {
+        free_str(p_cppyy_resolve_name(classes[i % classes.size()].c_str()));
+    });
+    bench(opts, names[2], opts.fIterations, [&typedefs](size_t i) {
+        free_str(p_cppyy_resolve_name(typedefs[i % typedefs.size()].c_str()));
+    });
+}
+
+void bench_threads(const Options& opts)
+{
+    if (!any_selected(opts, {"mt/reads_1", ("mt/reads_" + std::to_string(opts.fThreads)).c_str()}))
+        return;
+
+// reflection reads of an already loaded class (served under the shared
+// interpreter lock), per operation over all threads: flat with the number
+// of threads if reads run concurrently, growing if they are serialized
+    cppyy_scope_t klass = p_cppyy_get_scope("cppyy_bench::Obj");
+    auto reads = [klass](size_t iterations, long long* sink) {
+        long long local = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            local += p_cppyy_is_enum("cppyy_bench::Color");
+            local += (long long)p_cppyy_size_of_klass(klass);
+            local += p_cppyy_is_abstract(klass);
+        }
+        *sink = local;
+    };
+
+    std::vector<int> thread_counts{1};
+    if (opts.fThreads != 1)
+        thread_counts.push_back(opts.fThreads);
+
+    for (int nthreads : thread_counts) {
+        std::string name = "mt/reads_" + std::to_string(nthreads);
+        if (!selected(opts, name))
+            continue;
+
+        size_t per_thread = opts.fIterations/nthreads+1;
+        std::vector<long long> sinks(nthreads);
+        reads(per_thread/10+1, &sinks[0]);          // warmup
+        Result r{name, per_thread*nthreads*3, {}};
+        for (int irep = 0; irep < opts.fRepeat; ++irep) {
+            std::vector<std::thread> workers;
+            auto start = clock_t_::now();
+            for (int ithread = 0; ithread < nthreads; ++ithread)
+                workers.emplace_back(reads, per_thread, &sinks[ithread]);
+            for (auto& w : workers)
+                w.join();
+            r.fSamples.push_back(elapsed_ns(start, clock_t_::now())/r.fIterations);
+        }
+        for (auto sink : sinks)
+            gSink += sink;
+        gResults.push_back(r);
+    }
+}
+
+void bench_scope_threads(const Options& opts)
+{
+    std::string name = "mt/scopes_" + std::to_string(opts.fThreads);
+    if (!selected(opts, name))
+        return;
+
+// stress of the scope registry: all threads look up a known class (the shared
+// hit path) interleaved with first lookups of fresh classes, which insert, each
+// thread starting at a different offset so that inserts race with lookups of
+// the same names; afterwards, all threads must agree on each class handle
+    const size_t nclasses = std::min(opts.fClasses, (size_t)500);
+    const int nthreads = opts.fThreads;
+    Result r{name, nclasses*nthreads*2, {}};
+    bool consistent = true;
+    for (int irep = 0; irep < opts.fRepeat; ++irep) {
+        std::string ns = "cppyy_bench_mt" + std::to_string((long)getpid()) + "_" + std::to_string(irep);
+        std::string code = "namespace " + ns + " {\n";
+        for (size_t i = 0; i < nclasses; ++i)
+            code += "struct C" + std::to_string(i) + " { int m = " + std::to_string(i) + "; };\n";
+        p_cppyy_compile((code + "}").c_str());
+
+        std::vector<std::vector<cppyy_scope_t>> handles(nthreads, std::vector<cppyy_scope_t>(nclasses));
+        auto lookups = [&ns, nclasses, nthreads](int ithread, std::vector<cppyy_scope_t>* out) {
+            for (size_t j = 0; j < nclasses; ++j) {
+                size_t i = (j + ithread*nclasses/nthreads) % nclasses;
+                gSink += (long long)p_cppyy_get_scope("cppyy_bench::Obj");
+                (*out)[i] = p_cppyy_get_scope((ns + "::C" + std::to_string(i)).c_str());
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto start = clock_t_::now();
+        for (int ithread = 0; ithread < nthreads; ++ithread)
+            workers.emplace_back(lookups, ithread, &handles[ithread]);
+        for (auto& w : workers)
+            w.join();
+        r.fSamples.push_back(elapsed_ns(start, clock_t_::now())/r.fIterations);
+
+        for (size_t i = 0; i < nclasses; ++i) {
+            for (int ithread = 0; ithread < nthreads; ++ithread)
+                consistent = consistent && handles[ithread][i] && handles[ithread][i] == handles[0][i];
+        }
+    }
+    if (!consistent)
+        fprintf(stderr, "%s: threads disagree on scope handles\n", name.c_str());
+    gResults.push_back(r);
+}
+
+// memory written to by this process only (i.e. not shared with the parent), in kB
+double private_kb()
+{
+    double kb = 0.;
+    char line[256];
+    FILE* f = fopen("/proc/self/smaps_rollup", "r");
+    if (f) {
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, "Private_Dirty:", 14) == 0)
+                kb += strtod(line+14, nullptr);
+        }
+        fclose(f);
+    }
+    return kb;
+}
+
+void bench_fork(const Options& opts)
+{
+    const char* names[] = {"fork/cold_first_call", "fork/cold_private_kB",
+        "fork/preloaded_first_call", "fork/preloaded_private_kB"};
+    if (!any_selected(opts, {names[0], names[1], names[2], names[3]}))
+        return;
+
+// pre-forked workers: per child, the mean latency of the first call to each of
+// a set of classes (scope lookup, method lookup, JIT, call), and the memory it
+// did not share with the parent; without and with cppyy_preload() in the parent
+    const int nclasses = 50;
+    std::string code = "namespace cppyy_bench_fork {\n";
+    for (int i = 0; i < nclasses; ++i)
+        code += "struct K" + std::to_string(i) + " { static int m(int a) { return a+" + std::to_string(i) + "; } };\n";
+    code += "}";
+    p_cppyy_compile(code.c_str());
+    std::vector<std::string> scopes;
+    for (int i = 0; i < nclasses; ++i)
+        scopes.push_back("cppyy_bench_fork::K" + std::to_string(i));
+
+    auto run_children = [&opts, &scopes](const char* latency_name, const char* memory_name) {
+        Result latency{latency_name, scopes.size(), {}}, memory{memory_name, 1, {}, "kB"};
+        for (int irep = 0; irep < opts.fRepeat; ++irep) {
+            int fds[2];
+            if (pipe(fds) != 0)
+                return;
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                IntArgs args(1);
+                long long local = 0;
+                auto start = clock_t_::now();
+                for (auto& name : scopes) {
+                    cppyy_method_t m = find_method(p_cppyy_get_scope(name.c_str()), "m", 1);
+                    local += m ? p_cppyy_call_i(m, 0, args.fNArgs, args.fArgs) : 0;
+                }
+                double report[2] = {elapsed_ns(start, clock_t_::now())/scopes.size(), private_kb()};
+                gSink += local;
+                ssize_t sz = write(fds[1], report, sizeof(report));
+                _exit(sz == (ssize_t)sizeof(report) ? 0 : 1);
+            }
+            close(fds[1]);
+            double report[2];
+            bool ok = pid > 0 && read(fds[0], report, sizeof(report)) == (ssize_t)sizeof(report);
+            close(fds[0]);
+            if (pid > 0) waitpid(pid, nullptr, 0);
+            if (!ok) {
+                fprintf(stderr, "fork benchmark child failed\n");
+                return;
+            }
+            latency.fSamples.push_back(report[0]);
+            memory.fSamples.push_back(report[1]);
+        }
+        if (selected(opts, latency.fName)) gResults.push_back(latency);
+        if (selected(opts, memory.fName))  gResults.push_back(memory);
+    };
+
+    run_children(names[0], names[1]);
+
+    std::vector<const char*> cscopes;
+    for (auto& name : scopes)
+        cscopes.push_back(name.c_str());
+    p_cppyy_preload(nullptr, 0, cscopes.data(), (int)cscopes.size(), 1);
+    run_children(names[2], names[3]);
+}
+
+void bench_wrapper_memory(const Options& opts)
+{
+    if (!selected(opts, "object/resolve_growth_kB"))
+        return;
+
+// memory regression check: about 1M method resolutions over the same overloads
+// (each yielding the interned wrapper), with the growth of private memory per
+// block of 100k resolutions after a warmup block; should stay flat at ~0 kB
+    const size_t nblocks = 10, per_block = 100000;
+    cppyy_scope_t klass = p_cppyy_get_scope("cppyy_bench::Over");
+    int nmethods = p_cppyy_num_methods(klass);
+    if (nmethods <= 0)
+        return;
+    auto resolve = [klass, nmethods](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            gSink += (long long)p_cppyy_get_method(klass, (cppyy_index_t)(i % nmethods));
+        gSink += (long long)find_method(klass, "f");
+    };
+
+    resolve(per_block);
+    Result r{"object/resolve_growth_kB", per_block, {}, "kB"};
+    double kb = private_kb();
+    for (size_t iblock = 1; iblock < nblocks; ++iblock) {
+        resolve(per_block);
+        double now = private_kb();
+        r.fSamples.push_back(now - kb);
+        kb = now;
+    }
+    gResults.push_back(r);
+}
+
+void bench_rootmaps(const Options& opts)
+{
+    if (!any_selected(opts, {"rootmap/load", "rootmap/lookup"}))
+        return;
+
+// LoadLibraryMap() of rootmap files with <classes> keys each (per key), and the
+// library lookup for a class as done on autoload (GetClassSharedLibs); these
+// maps have no binary index, so that running the same on maps written by
+// rootcling (with their .idx, and with it removed) shows what the index saves
+    char dir[] = "/tmp/cppyy_bench_rootmapXXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "can not create a directory for rootmap files\n");
+        return;
+    }
+    std::vector<std::string> files;
+    for (int irep = 0; irep < opts.fRepeat+1; ++irep) {
+        std::string ns = "cppyy_bench_map" + std::to_string(irep);
+        files.push_back(std::string(dir) + "/lib" + ns + ".rootmap");
+        FILE* f = fopen(files.back().c_str(), "w");
+        if (!f) break;
+        fprintf(f, "[ lib%s.so ]\n", ns.c_str());
+        for (size_t i = 0; i < opts.fClasses; ++i)
+            fprintf(f, "class %s::K%zu\n", ns.c_str(), i);
+        fclose(f);
+    }
+
+    std::string code = "#include \"TInterpreter.h\"\n"
+        "namespace cppyy_bench_map {\n"
+        "int load(int i) { return gInterpreter->LoadLibraryMap(\n"
+        "    (\"" + std::string(dir) + "/libcppyy_bench_map\" + std::to_string(i) + \".rootmap\").c_str()); }\n"
+        "int lookup(int i) { return gInterpreter->GetClassSharedLibs(\n"
+        "    (\"cppyy_bench_map0::K\" + std::to_string(i)).c_str()) != nullptr; }\n"
+        "}";
+    if (files.size() == (size_t)opts.fRepeat+1 && p_cppyy_compile(code.c_str())) {
+        cppyy_scope_t scope = p_cppyy_get_scope("cppyy_bench_map");
+        cppyy_method_t load = find_method(scope, "load"), lookup = find_method(scope, "lookup");
+        IntArgs args(1);
+
+        *(int*)args.fArgs = 0;                     // warmup, and the map for lookups
+        gSink += p_cppyy_call_i(load, nullptr, 1, args.fArgs);
+        if (selected(opts, "rootmap/load")) {
+            Result r{"rootmap/load", opts.fClasses, {}};
+            for (int irep = 1; irep <= opts.fRepeat; ++irep) {
+                *(int*)args.fArgs = irep;
+                auto start = clock_t_::now();
+                gSink += p_cppyy_call_i(load, nullptr, 1, args.fArgs);
+                r.fSamples.push_back(elapsed_ns(start, clock_t_::now())/opts.fClasses);
+            }
+            gResults.push_back(r);
+        }
+        bench(opts, "rootmap/lookup", opts.fIterations, [&](size_t i) {
+            *(int*)args.fArgs = (int)(i % opts.fClasses);
+            gSink += p_cppyy_call_i(lookup, nullptr, 1, args.fArgs);
+        });
+    } else
+        fprintf(stderr, "failed to set up the rootmap benchmarks\n");
+
+    for (const auto& file : files)
+        unlink(file.c_str());
+    rmdir(dir);
+}
+
+void bench_serialize(const Options& opts)
+{
+    const char* names[] = {"serialize/stream_out", "serialize/stream_in",
+        "serialize/naive_out", "serialize/naive_in"};
+    if (!any_selected(opts, {names[0], names[1], names[2], names[3]}))
+        return;
+
+// a plain record, as shipped between worker processes: streamed by the backend,
+// versus copied member by member with the offsets from reflection (obtained
+// once, up front; sizes are taken as the distance to the next member)
+    p_cppyy_compile("namespace cppyy_bench { struct Rec {\n"
+        "    int fId = 1; double fX = 2., fY = 3., fZ = 4.; long long fStamp = 5;\n"
+        "    float fWeights[16] = {}; double fData[64] = {}; }; }");
+    cppyy_scope_t klass = p_cppyy_get_scope("cppyy_bench::Rec");
+    const size_t size = p_cppyy_size_of_klass(klass);
+    std::vector<std::pair<size_t, size_t>> members;     // offset, size
+    for (int i = 0; i < p_cppyy_num_datamembers(klass); ++i)
+        members.push_back({(size_t)p_cppyy_datamember_offset(klass, i), 0});
+    std::sort(members.begin(), members.end());
+    for (size_t i = 0; i < members.size(); ++i)
+        members[i].second = (i+1 < members.size() ? members[i+1].first : size) - members[i].first;
+
+    cppyy_object_t obj = p_cppyy_constructor(find_method(klass, "Rec", 0), klass, 0, nullptr);
+    std::vector<char> naive(size), stream(64*1024);
+    std::vector<double> arena((size + sizeof(double) - 1)/sizeof(double));
+
+// round-trip check: the re-serialized copy should be identical
+    char* buf = nullptr; size_t len = 0;
+    if (!obj || !p_cppyy_serialize(klass, obj, &buf, &len) || stream.size() < len) {
+        fprintf(stderr, "serialization of cppyy_bench::Rec failed\n");
+        return;
+    }
+    memcpy(stream.data(), buf, len);
+    cppyy_object_t copy = p_cppyy_deserialize(klass, stream.data(), len, arena.data());
+    buf = nullptr;
+    size_t len2 = 0;
+    if (!copy || !p_cppyy_serialize(klass, copy, &buf, &len2) || len2 != len || memcmp(buf, stream.data(), len) != 0) {
+        fprintf(stderr, "serialization round trip of cppyy_bench::Rec failed\n");
+        return;
+    }
+
+    bench(opts, names[0], opts.fIterations, [&](size_t) {
+        char* out = nullptr; size_t nout = 0;
+        gSink += p_cppyy_serialize(klass, obj, &out, &nout) ? (long long)nout : 0;
+    });
+    bench(opts, names[1], opts.fIterations, [&](size_t) {
+        gSink += (long long)p_cppyy_deserialize(klass, stream.data(), len, arena.data());
+    });
+    bench(opts, names[2], opts.fIterations, [&](size_t) {
+        size_t pos = 0;
+        for (auto& m : members) {
+            memcpy(naive.data() + pos, (char*)obj + m.first, m.second);
+            pos += m.second;
+        }
+        gSink += naive[pos/2];
+    });
+    bench(opts, names[3], opts.fIterations, [&](size_t) {
+        size_t pos = 0;
+        for (auto& m : members) {
+            memcpy((char*)arena.data() + m.first, naive.data() + pos, m.second);
+            pos += m.second;
+        }
+        gSink += (long long)arena[0];
+    });
+
+    p_cppyy_destruct(klass, obj);
+}
+
+
+//- driver -------------------------------------------------------------------
+void write_json(FILE* out, const Options& opts)
+{
+    fprintf(out, "{\n  \"version\": 1,\n  \"library\": \"%s\",\n  \"repeat\": %d,\n  \"results\": [",
+            opts.fLib.c_str(), opts.fRepeat);
+    const char* sep = "\n";
+    for (auto& r : gResults) {
+        std::vector<double> s = r.fSamples;
+        std::sort(s.begin(), s.end());
+        double mean = 0.;
+        for (double v : s) mean += v;
+        mean /= s.size();
+        double median = s.size() % 2 ? s[s.size()/2] : (s[s.size()/2-1] + s[s.size()/2])/2.;
+        fprintf(out, "%s    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %zu, \"samples\": %zu, "
+                     "\"min\": %.1f, \"median\": %.1f, \"mean\": %.1f, \"max\": %.1f}",
+                sep, r.fName.c_str(), r.fUnit.c_str(), r.fIterations, s.size(), s.front(), median, mean, s.back());
+        sep = ",\n";
+    }
+    fprintf(out, "\n  ]");
+
+    if (p_cppyy_instrument_snapshot) {
+        cppyy_instrument_stat_t stats[64];
+        int ncats = std::min(p_cppyy_instrument_snapshot(stats, 64), 64);
+        fprintf(out, ",\n  \"instrumentation\": {");
+        sep = "\n";
+        for (int icat = 0; icat < ncats; ++icat) {
+            fprintf(out, "%s    \"%s\": {\"count\": %llu, \"total_ns\": %llu, \"max_ns\": %llu}",
+                    sep, stats[icat].category, stats[icat].count, stats[icat].total_ns, stats[icat].max_ns);
+            sep = ",\n";
+        }
+        fprintf(out, "\n  }");
+    }
+    fprintf(out, "\n}\n");
+}
+
+// load the backend in a child with eager PCM loading; reports time and memory
+bool startup_child(const Options& opts, double report[2])
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        setenv("CPPYY_EAGER_PCM", "1", 1);
+        auto start = clock_t_::now();
+        void* lib = dlopen(opts.fLib.c_str(), RTLD_NOW | RTLD_GLOBAL);
+        double result[2] = {elapsed_ns(start, clock_t_::now()), private_kb()};
+        ssize_t sz = lib ? write(fds[1], result, sizeof(result)) : 0;
+        _exit(sz == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    bool ok = pid > 0 && read(fds[0], report, 2*sizeof(double)) == (ssize_t)(2*sizeof(double));
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, nullptr, 0);
+    return ok;
+}
+
+void usage(const char* prog)
+{
+    fprintf(stderr,
+        "usage: %s [--lib <libcppyy_backend>] [--out <file.json>] [--filter <substring>]\n"
+        "          [--repeat <n>] [--iterations <n>] [--classes <n>] [--threads <n>]\n"
+        "benchmarks: startup/, scope/, jit/, call/, object/, overload/, reflect/, names/, mt/, fork/,\n"
+        "            serialize/, rootmap/\n", prog);
+}
+
+bool parse_args(int argc, char** argv, Options& opts)
+{
+    const char* lib = std::getenv("CPPYY_BACKEND_LIBRARY");
+    opts.fLib = lib ? lib : "libcppyy_backend.so";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i+1 == argc) return false;
+        const char* val = argv[++i];
+        if (arg == "--lib")             opts.fLib = val;
+        else if (arg == "--out")        opts.fOut = val;
+        else if (arg == "--filter")     opts.fFilter = val;
+        else if (arg == "--repeat")     opts.fRepeat = std::max(atoi(val), 1);
+        else if (arg == "--iterations") opts.fIterations = std::max(strtoul(val, nullptr, 10), 1ul);
+        else if (arg == "--classes")    opts.fClasses = strtoul(val, nullptr, 10);
+        else if (arg == "--threads")    opts.fThreads = std::max(atoi(val), 1);
+        else return false;
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+// cold start: loading the backend starts the interpreter (ApplicationStarter);
+// for comparison, the same is done first in a child with the proto classes of
+// the dictionaries deserialized eagerly (CPPYY_EAGER_PCM) rather than on use
+    if (any_selected(opts, {"startup/load_eager", "startup/private_kB_eager"})) {
+        double report[2];
+        if (!startup_child(opts, report))
+            fprintf(stderr, "eager startup benchmark child failed\n");
+        else {
+            if (selected(opts, "startup/load_eager"))
+                add_sample("startup/load_eager", 1, report[0]);
+            if (selected(opts, "startup/private_kB_eager"))
+                gResults.push_back(Result{"startup/private_kB_eager", 1, {report[1]}, "kB"});
+        }
+    }
+
+    auto start = clock_t_::now();
+    void* lib = dlopen(opts.fLib.c_str(), RTLD_NOW | RTLD_GLOBAL);
+    double startup = elapsed_ns(start, clock_t_::now());
+    if (!lib) {
+        fprintf(stderr, "failed to load %s: %s\n", opts.fLib.c_str(), dlerror());
+        return 1;
+    }
+    if (selected(opts, "startup/load"))
+        add_sample("startup/load", 1, startup);
+    if (selected(opts, "startup/private_kB"))
+        gResults.push_back(Result{"startup/private_kB", 1, {private_kb()}, "kB"});
+
+    bool ok = true;
+#define CPPYY_BENCH_LOAD(name)                                                \
+    p_##name = (decltype(p_##name))dlsym(lib, #name);                         \
+    if (!p_##name && strcmp(#name, "cppyy_instrument_snapshot") != 0) {       \
+        fprintf(stderr, "missing symbol %s\n", #name);                        \
+        ok = false;                                                           \
+    }
+    CPPYY_BENCH_APIS(CPPYY_BENCH_LOAD)
+#undef CPPYY_BENCH_LOAD
+    if (!ok)
+        return 1;
+
+    std::string code = "namespace cppyy_bench {\n";
+    for (int nargs : {0, 1, 8, 16})
+        code += "int f" + std::to_string(nargs) + int_params(nargs) + "\n";
+    code += "int fn1(int a) noexcept { return a; }\n"
+            "struct Obj { Obj() : fA(0) {} Obj(int a) : fA(a) {} int fA; };\n"
+            "enum Color { kRed, kGreen, kBlue };\n"
+            "struct Over {\n";
+    const char* types[] = {"int", "long", "double", "float", "short", "const char*", "const std::string&", "void*"};
+    for (int i = 0; i < 32; ++i) {
+        code += "    int f(" + std::string(types[i%8]) + " a";
+        for (int j = 0; j < i/8; ++j)
+            code += ", int b" + std::to_string(j);
+        code += ") { return " + std::to_string(i) + "; }\n";
+    }
+    code += "};\n}";
+    p_cppyy_compile("#include <string>");
+    if (!p_cppyy_compile(code.c_str())) {
+        fprintf(stderr, "failed to compile benchmark code\n");
+        return 1;
+    }
+
+    bench_scopes(opts);
+    bench_jit(opts);
+    bench_calls(opts);
+    bench_objects(opts);
+    bench_overloads(opts);
+    bench_reflection(opts);
+    bench_names(opts);
+    bench_resolve(opts);
+    bench_threads(opts);
+    bench_scope_threads(opts);
+    bench_fork(opts);
+    bench_wrapper_memory(opts);
+    bench_serialize(opts);
+    bench_rootmaps(opts);
+
+    FILE* out = opts.fOut.empty() ? stdout : fopen(opts.fOut.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "can not open %s for writing\n", opts.fOut.c_str());
+        return 1;
+    }
+    write_json(out, opts);
+    if (out != stdout)
+        fclose(out);
+
+    return 0;
+}
@@ -1,5 +1,5 @@
 import codecs, glob, os, sys, subprocess
-from setuptools import setup, find_packages, Extension
+from setuptools import setup, find_packages, Extension, Command
 from distutils import log
 
 from setuptools.command.install import install as _install
@@ -129,9 +129,44 @@ class my_install(_install):
     def run(self):
         return _install.run(self)
 
+class my_build_bench(Command):
+    description = 'build the native benchmarks of the C API (bench/cppyy_bench)'
+    user_options = []
+
+    def initialize_options(self):
+        self.build_temp = None
+
+    def finalize_options(self):
+        self.set_undefined_options('build_ext', ('build_temp', 'build_temp'))
+
+    def run(self):
+        if 'win32' in sys.platform:
+            raise DistutilsSetupError('the benchmarks require dlopen() and are not supported on Windows')
+
+        self.run_command('build_ext')
+
+        from distutils.ccompiler import new_compiler
+        from distutils.sysconfig import customize_compiler
+        compiler = new_compiler(dry_run=self.dry_run, force=self.force)
+        customize_compiler(compiler)
+
+        objects = compiler.compile(
+            [os.path.join('bench', 'cppyy_bench.cxx')],
+            output_dir=self.build_temp,
+            include_dirs=['src'],
+            extra_postargs=['-O2']+get_cflags().split())
+
+        log.info("now building cppyy_bench")
+        compiler.link_executable(
+            objects, 'cppyy_bench',
+            libraries=['dl', 'pthread'],
+            output_dir=self.build_temp,
+            target_lang='c++')
+
 
 cmdclass = {
         'build_ext': my_build_cpplib,
+        'build_bench': my_build_bench,
         #'clean': my_clean,
         'install': my_install }
 
@@ -17,6 +17,7 @@ extern "C" {
 
     typedef size_t        cppyy_index_t;
     typedef void*         cppyy_funcaddr_t;
+    typedef void*         cppyy_heap_t;
 
     typedef unsigned long cppyy_exctype_t;
 
@@ -36,6 +37,8 @@ extern "C" {
     RPY_EXPORTED
     cppyy_scope_t cppyy_get_scope(const char* scope_name);
     RPY_EXPORTED
+    void cppyy_scope_miss_stats(unsigned long long* hits, unsigned long long* added, unsigned long long* flushes);
+    RPY_EXPORTED
     cppyy_type_t cppyy_actual_class(cppyy_type_t klass, cppyy_object_t obj);
     RPY_EXPORTED
     size_t cppyy_size_of_klass(cppyy_type_t klass);
@@ -85,6 +88,30 @@ extern "C" {
     void* cppyy_call_r(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
     RPY_EXPORTED
     char* cppyy_call_s(cppyy_method_t method, cppyy_object_t self, int nargs, void* args, size_t* length);
+    /* no exception translation for methods that can not throw (others take the regular path) */
+    RPY_EXPORTED
+    int cppyy_is_noexcept(cppyy_method_t method);
+    RPY_EXPORTED
+    void cppyy_call_v_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    unsigned char cppyy_call_b_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    char cppyy_call_c_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    short cppyy_call_h_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    int cppyy_call_i_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    long cppyy_call_l_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    long long cppyy_call_ll_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    float cppyy_call_f_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    double cppyy_call_d_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+    RPY_EXPORTED
+    void* cppyy_call_r_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args);
+
     RPY_EXPORTED
     cppyy_object_t cppyy_constructor(cppyy_method_t method, cppyy_type_t klass, int nargs, void* args);
     RPY_EXPORTED
@@ -92,8 +119,25 @@ extern "C" {
     RPY_EXPORTED
     cppyy_object_t cppyy_call_o(cppyy_method_t method, cppyy_object_t self, int nargs, void* args, cppyy_type_t result_type);
 
+    /* bulk calls: one call per row, with argument i of row k at args_columns[i] + k*strides[i];
+       selves may be NULL for static functions; returns 0 on failure */
+    RPY_EXPORTED
+    int cppyy_call_i_batch(cppyy_method_t method, cppyy_object_t* selves, int nargs, void** args_columns, size_t* strides, size_t n, int* out);
+    RPY_EXPORTED
+    int cppyy_call_l_batch(cppyy_method_t method, cppyy_object_t* selves, int nargs, void** args_columns, size_t* strides, size_t n, long* out);
+    RPY_EXPORTED
+    int cppyy_call_ll_batch(cppyy_method_t method, cppyy_object_t* selves, int nargs, void** args_columns, size_t* strides, size_t n, long long* out);
+    RPY_EXPORTED
+    int cppyy_call_f_batch(cppyy_method_t method, cppyy_object_t* selves, int nargs, void** args_columns, size_t* strides, size_t n, float* out);
+    RPY_EXPORTED
+    int cppyy_call_d_batch(cppyy_method_t method, cppyy_object_t* selves, int nargs, void** args_columns, size_t* strides, size_t n, double* out);
+
     RPY_EXPORTED
     cppyy_funcaddr_t cppyy_function_address(cppyy_method_t method);
+    RPY_EXPORTED
+    void cppyy_prepare_wrappers(cppyy_method_t* methods, int nmethods);
+    RPY_EXPORTED
+    void cppyy_wait_for_wrappers();
 
     /* handling of function argument buffer ----------------------------------- */
     RPY_EXPORTED
@@ -121,6 +165,9 @@ extern "C" {
 
     RPY_EXPORTED
     const char** cppyy_get_all_cpp_names(cppyy_scope_t scope, size_t* count);
+    /* as above, but in a single allocation: free only the result (with cppyy_free) */
+    RPY_EXPORTED
+    const char** cppyy_get_all_cpp_names_packed(cppyy_scope_t scope, size_t* count);
 
     /* namespace reflection information --------------------------------------- */
     RPY_EXPORTED
@@ -270,6 +317,154 @@ extern "C" {
     RPY_EXPORTED
     long long     cppyy_get_enum_data_value(cppyy_enum_t, cppyy_index_t idata);
 
+    /* bulk reflection information -------------------------------------------- */
+    /* same layout as Cppyy::TCpp*Desc_t; property bits as Cppyy::EDescProperty */
+    enum {
+        CPPYY_DESC_PUBLIC       = 0x0001,
+        CPPYY_DESC_PROTECTED    = 0x0002,
+        CPPYY_DESC_STATIC       = 0x0004,
+        CPPYY_DESC_CONST        = 0x0008,
+        CPPYY_DESC_CONSTRUCTOR  = 0x0010,
+        CPPYY_DESC_DESTRUCTOR   = 0x0020,
+        CPPYY_DESC_EXPLICIT     = 0x0040,
+        CPPYY_DESC_ENUMDATA     = 0x0080,
+        CPPYY_DESC_NAMESPACE    = 0x0100,
+        CPPYY_DESC_ABSTRACT     = 0x0200,
+        CPPYY_DESC_AGGREGATE    = 0x0400,
+        CPPYY_DESC_DEFAULTCTOR  = 0x0800,
+        CPPYY_DESC_VIRTUALDTOR  = 0x1000,
+        CPPYY_DESC_COMPLEX      = 0x2000,
+        CPPYY_DESC_SMARTPTR     = 0x4000
+    };
+
+    typedef struct {
+        const char* name;
+        const char* type;
+        const char* defvalue;
+    } cppyy_arg_desc_t;
+
+    typedef struct {
+        cppyy_method_t method;
+        const char* name;
+        const char* result_type;
+        cppyy_arg_desc_t* args;
+        unsigned int nargs;
+        unsigned int req_args;
+        unsigned int property;
+    } cppyy_method_desc_t;
+
+    typedef struct {
+        const char* name;
+        const char* type;
+        intptr_t offset;
+        unsigned int property;
+    } cppyy_datamember_desc_t;
+
+    typedef struct {
+        const char* name;
+        long long value;
+    } cppyy_enum_const_desc_t;
+
+    typedef struct {
+        cppyy_enum_t e;
+        const char* name;
+        cppyy_enum_const_desc_t* constants;
+        unsigned int nconstants;
+    } cppyy_enum_desc_t;
+
+    typedef struct {
+        cppyy_scope_t scope;
+        const char* name;
+        const char* scoped_name;
+        size_t size;
+        unsigned int property;
+        unsigned int nbases;
+        const char** bases;
+        unsigned int nmethods;
+        cppyy_method_desc_t* methods;
+        unsigned int ndatamembers;
+        cppyy_datamember_desc_t* datamembers;
+        unsigned int nenums;
+        cppyy_enum_desc_t* enums;
+    } cppyy_scope_desc_t;
+
+    /* single block, strings included; release with cppyy_free */
+    RPY_EXPORTED
+    cppyy_scope_desc_t* cppyy_describe_scope(cppyy_scope_t scope);
+
+    /* instrumentation -------------------------------------------------------- */
+    typedef struct {
+        const char* category;
+        unsigned long long count;
+        unsigned long long total_ns;
+        unsigned long long max_ns;
+    } cppyy_instrument_stat_t;
+
+    /* returns the previous state */
+    RPY_EXPORTED
+    int cppyy_instrument_enable(int enable);
+    RPY_EXPORTED
+    void cppyy_instrument_reset();
+    /* fills up to nstats entries; returns the number of categories */
+    RPY_EXPORTED
+    int cppyy_instrument_snapshot(cppyy_instrument_stat_t* stats, int nstats);
+    /* human readable report, incl. per-name statistics; release with cppyy_free */
+    RPY_EXPORTED
+    char* cppyy_instrument_report();
+
+    /* preloading (warm-up before fork()) ------------------------------------- */
+    /* loads the libraries, resolves the scopes and, if wrappers is set, JITs the
+       wrappers of their methods; returns 1 if all succeeded (loading continues
+       past failures) */
+    RPY_EXPORTED
+    int cppyy_preload(const char** libraries, int nlibs, const char** scopes, int nscopes, int wrappers);
+    /* make fork() from a thread other than the worker(s) safe; returns 0 if not supported */
+    RPY_EXPORTED
+    int cppyy_enable_fork_safety();
+
+    /* serialization ---------------------------------------------------------- */
+    /* streams obj into *buf if not NULL (with capacity *len; if too small, returns
+       0 with the required size in *len), else sets *buf to a per-thread buffer that
+       stays valid until the next call on the same thread; *len is the number of
+       bytes written; returns 1 on success */
+    RPY_EXPORTED
+    int cppyy_serialize(cppyy_type_t type, cppyy_object_t obj, char** buf, size_t* len);
+    /* reads an object of type from buf, constructing it in arena if not NULL (at
+       least cppyy_size_of_klass(type) large), else on the heap; returns 0 on failure */
+    RPY_EXPORTED
+    cppyy_object_t cppyy_deserialize(cppyy_type_t type, const char* buf, size_t len, void* arena);
+
+    /* shared-memory heaps ---------------------------------------------------- */
+    /* creates a heap of size bytes (less than 2GB), backed by the new file path,
+       mapped at base if not NULL; returns NULL on failure */
+    RPY_EXPORTED
+    cppyy_heap_t cppyy_create_shared_heap(const char* path, size_t size, void* base);
+    /* attaches an existing heap, which must be mappable at its original address */
+    RPY_EXPORTED
+    cppyy_heap_t cppyy_attach_shared_heap(const char* path);
+    RPY_EXPORTED
+    void cppyy_detach_shared_heap(cppyy_heap_t heap);
+    RPY_EXPORTED
+    void* cppyy_heap_allocate(cppyy_heap_t heap, size_t size);
+    RPY_EXPORTED
+    void cppyy_heap_deallocate(cppyy_heap_t heap, void* ptr);
+    /* default constructs an object of type in the heap and, if name is not NULL
+       or empty, registers it under that name; returns 0 on failure */
+    RPY_EXPORTED
+    cppyy_object_t cppyy_heap_construct(cppyy_heap_t heap, cppyy_type_t type, const char* name);
+    /* destroys and frees an object constructed in the heap, and drops its name */
+    RPY_EXPORTED
+    void cppyy_heap_destruct(cppyy_heap_t heap, cppyy_type_t type, cppyy_object_t obj);
+    /* returns the object registered under name (0 if none) and, if type is not
+       NULL, its type in the calling process */
+    RPY_EXPORTED
+    cppyy_object_t cppyy_heap_lookup(cppyy_heap_t heap, const char* name, cppyy_type_t* type);
+    /* heap for cppyy::heap_allocator<T> on the calling thread (NULL: global new) */
+    RPY_EXPORTED
+    cppyy_heap_t cppyy_set_current_heap(cppyy_heap_t heap);
+    RPY_EXPORTED
+    cppyy_heap_t cppyy_current_heap();
+
     /* misc helpers ----------------------------------------------------------- */
     RPY_EXPORTED
     long long cppyy_strtoll(const char* str);
@@ -9,9 +9,12 @@
 #include "capi.h"
 #include "cpp_cppyy.h"
 #include "callcontext.h"
+#include "nametable.h"
 
 // ROOT
+#include "RZip.h"
 #include "TBaseClass.h"
+#include "TBufferFile.h"
 #include "TClass.h"
 #include "TClassRef.h"
 #include "TClassTable.h"
@@ -28,6 +31,7 @@
 #include "TFunctionTemplate.h"
 #include "TGlobal.h"
 #include "THashList.h"
+#include "TInstrumentation.h"
 #include "TInterpreter.h"
 #include "TList.h"
 #include "TListOfDataMembers.h"
@@ -41,16 +45,29 @@
 // Standard
 #include <cassert>
 #include <algorithm>     // for std::count, std::remove
+#include <atomic>
+#include <cerrno>
 #include <climits>
+#include <condition_variable>
+#include <deque>
 #include <stdexcept>
 #include <map>
+#include <mutex>
 #include <new>
 #include <set>
+#include <shared_mutex>
 #include <sstream>
+#include <thread>
 #include <csignal>
 #include <cstdlib>      // for getenv
 #include <cstring>
 #include <typeinfo>
+#ifndef WIN32
+#include <fcntl.h>
+#include <pthread.h>    // for pthread_atfork and shared heap locks
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #if defined(__arm64__)
 #include <exception>
@@ -70,6 +87,16 @@ if (setjmp(gExcJumBuf) == 0) {
 #define _CLING_CATCH_UNCAUGHT
 #endif
 
+// calls into functions that can not throw need no guard
+#define CLING_CALL_GUARDED(nothrow, call)                                    \
+if (nothrow) {                                                               \
+    call;                                                                    \
+} else {                                                                     \
+    CLING_CATCH_UNCAUGHT_                                                    \
+    call;                                                                    \
+    _CLING_CATCH_UNCAUGHT                                                    \
+}
+
 // force std::string and allocator instantation, otherwise Clang 13+ fails to JIT
 // symbols that rely on some private helpers (e.g. _M_use_local_data) when used in
 // in conjunction with the PCH; hat tip:
@@ -118,27 +145,143 @@ static inline size_t CALL_NARGS(size_t nargs) {
 }
 
 // data for life time management ---------------------------------------------
-typedef std::vector<TClassRef> ClassRefs_t;
+namespace {
+
+// Append-only table of scopes, indexed by scope handle. Storage is allocated in
+// fixed-size segments that are never moved or released (until shutdown), so a
+// handle stays valid forever and readers need no lock. Appends must be
+// serialized by the caller (see gScopeMutex); the new size is published only
+// after the entry has been constructed.
+class ClassRefs_t {
+public:
+    typedef size_t size_type;
+
+public:
+    ClassRefs_t(size_type n) : fSize(0) {
+        for (auto& seg : fSegments) seg.store(nullptr, std::memory_order_relaxed);
+        for (size_type i = 0; i < n; ++i) push_back(TClassRef());
+    }
+    ~ClassRefs_t() {
+        for (auto& seg : fSegments) delete [] seg.load(std::memory_order_relaxed);
+    }
+
+    size_type size() const { return fSize.load(std::memory_order_acquire); }
+
+    TClassRef& operator[](size_type idx) {
+        return fSegments[idx >> kSegmentBits].load(std::memory_order_acquire)[idx & kSegmentMask];
+    }
+
+    void push_back(const TClassRef& cr) {
+        size_type idx = fSize.load(std::memory_order_relaxed);
+        size_type iseg = idx >> kSegmentBits;
+        if (kMaxSegments <= iseg)
+            throw std::runtime_error("too many scopes");
+        TClassRef* seg = fSegments[iseg].load(std::memory_order_relaxed);
+        if (!seg) {
+            seg = new TClassRef[kSegmentSize];
+            fSegments[iseg].store(seg, std::memory_order_release);
+        }
+        seg[idx & kSegmentMask] = cr;
+        fSize.store(idx+1, std::memory_order_release);
+    }
+
+private:
+    static const size_type kSegmentBits = 10;
+    static const size_type kSegmentSize = (size_type)1 << kSegmentBits;
+    static const size_type kSegmentMask = kSegmentSize - 1;
+    static const size_type kMaxSegments = 4096;     // i.e. ~4M scopes
+
+    std::atomic<TClassRef*> fSegments[kMaxSegments];
+    std::atomic<size_type>  fSize;
+};
+
+} // unnamed namespace
+
 static ClassRefs_t g_classrefs(1);
 static const ClassRefs_t::size_type GLOBAL_HANDLE = 1;
 static const ClassRefs_t::size_type STD_HANDLE = GLOBAL_HANDLE + 1;
 
-typedef std::map<std::string, ClassRefs_t::size_type> Name2ClassRefIndex_t;
+typedef Cppyy::NameTable<ClassRefs_t::size_type> Name2ClassRefIndex_t;
 static Name2ClassRefIndex_t g_name2classrefidx;
 
-static std::map<std::string, std::string> resolved_enum_types;
+// lock for the scope registry: protects g_name2classrefidx and appends to
+// g_classrefs (reads of g_classrefs through type_from_handle are lock-free);
+// lookups, the hot path, only take it shared (shared_timed_mutex, as this
+// needs to remain C++14)
+typedef std::shared_timed_mutex ScopeMutex_t;
+static ScopeMutex_t gScopeMutex;
+
+// negative lookup cache: names that failed to resolve to a scope; these stay
+// valid for as long as no declarations were added to the interpreter and no
+// classes were registered (both happen on library loads), also under gScopeMutex
+static Cppyy::NameSet gScopeMisses;
+static ULong64_t gScopeMissesMarker = 0;
+static int gScopeMissesNClasses = 0;
+static ULong64_t gScopeMissesHits = 0, gScopeMissesAdded = 0, gScopeMissesFlushes = 0;
+
+// underlying types of enums, by enum type name, also under gScopeMutex
+static Cppyy::NameTable<std::string> resolved_enum_types;
 
 namespace {
 
 static inline
-Cppyy::TCppType_t find_memoized_scope(const std::string& name)
+Cppyy::TCppType_t find_memoized_scope_nolock(const char* name, size_t len)
 {
-    auto icr = g_name2classrefidx.find(name);
-    if (icr != g_name2classrefidx.end())
-        return (Cppyy::TCppType_t)icr->second;
+    auto icr = g_name2classrefidx.find(name, len);
+    if (icr)
+        return (Cppyy::TCppType_t)*icr;
     return (Cppyy::TCppType_t)0;
 }
 
+static inline
+Cppyy::TCppType_t find_memoized_scope(const char* name, size_t len)
+{
+    std::shared_lock<ScopeMutex_t> lock(gScopeMutex);
+    return find_memoized_scope_nolock(name, len);
+}
+
+static inline
+Cppyy::TCppType_t find_memoized_scope(const std::string& name)
+{
+    return find_memoized_scope(name.data(), name.size());
+}
+
+static inline
+void validate_scope_misses_nolock()
+{
+    ULong64_t marker = gInterpreter->GetInterpreterStateMarker();
+    int nclasses = gClassTable ? gClassTable->Classes() : 0;
+    if (marker != gScopeMissesMarker || nclasses != gScopeMissesNClasses) {
+        if (!gScopeMisses.empty()) {
+            gScopeMisses.clear();
+            gScopeMissesFlushes += 1;
+        }
+        gScopeMissesMarker = marker;
+        gScopeMissesNClasses = nclasses;
+    }
+}
+
+static inline
+bool is_scope_miss(const std::string& name)
+{
+    std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
+    validate_scope_misses_nolock();
+    if (gScopeMisses.contains(name)) {
+        gScopeMissesHits += 1;
+        return true;
+    }
+    return false;
+}
+
+static inline
+void add_scope_miss(const std::string& name)
+{
+    std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
+    validate_scope_misses_nolock();
+    gScopeMisses.insert(name);
+    gScopeMissesAdded += 1;
+}
+
 static inline
 std::string find_memoized_resolved_name(const std::string& name)
 {
@@ -147,9 +290,10 @@ std::string find_memoized_resolved_name(const std::string& name)
     if (klass) return Cppyy::GetScopedFinalName(klass);
 
 // resolved enum types
+    std::shared_lock<ScopeMutex_t> lock(gScopeMutex);
     auto res = resolved_enum_types.find(name);
-    if (res != resolved_enum_types.end())
-        return res->second;
+    if (res)
+        return *res;
 
 // unknown ...
     return "";
@@ -158,30 +302,205 @@ std::string find_memoized_resolved_name(const std::string& name)
 class CallWrapper {
 public:
     typedef const void* DeclId_t;
+    enum EAsyncState { kIdle, kQueued, kCompiling };
+    enum EFailed { kFailedDirect = 0x01, kFailedIface = 0x02, kFailedBatch = 0x04 };
 
 public:
     CallWrapper(TFunction* f) : fDecl(f->GetDeclId()), fName(f->GetName()), fTF(new TFunction(*f)) {}
     CallWrapper(DeclId_t fid, const std::string& n) : fDecl(fid), fName(n), fTF(nullptr) {}
     ~CallWrapper() {
+        delete fMeta;
         delete fTF;
     }
 
+public:
+    struct MemoString {
+        bool        fSet = false;
+        std::string fValue;
+    };
+    struct MemoQualTypes {
+        bool        fSet = false;
+        void*       fType = nullptr;    // as declared
+        void*       fBase = nullptr;    // w/o pointer, reference, and qualifiers
+    };
+    struct MetaCache {                  // memoized reflection information
+        MemoString  fResultType;
+        MemoString  fSignature[2];      // w/o and with formal args
+        MemoString  fPrototype[2];
+        size_t      fProtoScope = (size_t)-1;
+        std::vector<MemoString>    fArgTypes;
+        std::vector<MemoQualTypes> fArgQualTypes;
+    };
+
 public:
     TInterpreter::CallFuncIFacePtr_t fFaceptr;
+    TInterpreter::CallFuncBatch_t    fBatch = nullptr;
+    std::atomic<signed char> fNoexcept{-1};   // -1 if not yet determined
+    std::atomic<unsigned char> fFailed{0};    // EFailed kinds that did not build
     DeclId_t      fDecl;
     std::string   fName;
     TFunction*    fTF;
+    MetaCache*    fMeta = nullptr;
+    std::atomic<int> fAsyncState{kIdle};
+};
+
+
+// background compilation of wrappers ahead of their first call; the worker
+// holds the interpreter lock while compiling a batch, callers only block if
+// the wrapper they need is being compiled, and take over queued ones
+class WrapperCompiler {
+public:
+    ~WrapperCompiler() { Stop(); }
+
+    void Enqueue(CallWrapper* wrap) {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            if (fStop) return;
+            wrap->fAsyncState = CallWrapper::kQueued;
+            fQueue.push_back(wrap);
+            if (!fPaused && !fThread.joinable())
+                fThread = std::thread(&WrapperCompiler::Run, this);
+        }
+        fWork.notify_one();
+    }
+
+    void Claim(CallWrapper* wrap) {
+    // on return, wrap is not in flight; if it was still queued, the worker
+    // will skip it and the caller compiles it on the spot
+        std::unique_lock<std::mutex> lock(fMutex);
+        if (wrap->fAsyncState == CallWrapper::kQueued)
+            wrap->fAsyncState = CallWrapper::kIdle;
+        else
+            fDone.wait(lock, [wrap] { return wrap->fAsyncState == CallWrapper::kIdle; });
+    }
+
+    void Drain() {
+        std::unique_lock<std::mutex> lock(fMutex);
+        if (!fStop && !fQueue.empty() && !fThread.joinable())
+            fThread = std::thread(&WrapperCompiler::Run, this);   // see ForkRelease
+        fDone.wait(lock, [this] { return fQueue.empty() && !fBusy; });
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fStop = true;
+        }
+        fWork.notify_all();
+        if (fThread.joinable())
+            fThread.join();
+    }
+
+    void ForkPrepare() {
+    // finish the batch in flight and end the worker thread, keeping the queue
+    // (fork() does not duplicate threads), then hold the lock across fork()
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fPaused = true;
+        }
+        fWork.notify_all();
+        if (fThread.joinable())
+            fThread.join();
+        fMutex.lock();
+    }
+
+    void ForkRelease() {
+    // no thread is started here (this runs in the fork handlers); the worker is
+    // restarted on the next Enqueue() or Drain(), the queue is kept meanwhile,
+    // and Claim() has callers compile queued wrappers themselves
+        fPaused = false;
+        fMutex.unlock();
+    }
+
+private:
+    void Run() {
+        std::vector<Cppyy::TCppMethod_t> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(fMutex);
+                fWork.wait(lock, [this] { return fStop || fPaused || !fQueue.empty(); });
+                if (fStop || fPaused) break;
+                for (auto wrap : fQueue) {
+                    if (wrap->fAsyncState == CallWrapper::kQueued) {
+                        wrap->fAsyncState = CallWrapper::kCompiling;
+                        batch.push_back((Cppyy::TCppMethod_t)wrap);
+                    }
+                }
+                fQueue.clear();
+                fBusy = true;
+            }
+
+            if (!batch.empty()) {
+                R__LOCKGUARD_CLING(gInterpreterMutex);
+                Cppyy::PrepareWrappers(batch);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(fMutex);
+                for (auto method : batch)
+                    ((CallWrapper*)method)->fAsyncState = CallWrapper::kIdle;
+                fBusy = false;
+            }
+            fDone.notify_all();
+            batch.clear();
+        }
+
+    // release anyone waiting on a drain (unless paused: the queue is kept)
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (!fStop) return;
+        for (auto wrap : fQueue)
+            wrap->fAsyncState = CallWrapper::kIdle;
+        fQueue.clear();
+        fDone.notify_all();
+    }
+
+private:
+    std::mutex fMutex;
+    std::condition_variable fWork;
+    std::condition_variable fDone;
+    std::deque<CallWrapper*> fQueue;
+    bool fBusy = false;
+    bool fStop = false;
+    bool fPaused = false;
+    std::thread fThread;
 };
 
 }
 
 static std::vector<CallWrapper*> gWrapperHolder;
+static std::map<CallWrapper::DeclId_t, CallWrapper*> gWrappersByDecl;
+static std::mutex gWrapperMutex;      // protects the above two
+static WrapperCompiler gWrapperCompiler;
+static bool gAsyncWrappers = false;
 
 static inline
 CallWrapper* new_CallWrapper(TFunction* f)
 {
+// wrappers are interned by declaration, so that repeated lookups of the same
+// function neither grow memory nor need to recompile the wrapper; the copy of
+// the TFunction is made outside the lock (it calls into the interpreter), so a
+// thread losing a race drops its copy in favor of the interned one
+    CallWrapper::DeclId_t declid = f->GetDeclId();
+    if (declid) {
+        std::lock_guard<std::mutex> lock(gWrapperMutex);
+        auto existing = gWrappersByDecl.find(declid);
+        if (existing != gWrappersByDecl.end())
+            return existing->second;
+    }
+
     CallWrapper* wrap = new CallWrapper(f);
-    gWrapperHolder.push_back(wrap);
+    {
+        std::lock_guard<std::mutex> lock(gWrapperMutex);
+        if (declid) {
+            auto res = gWrappersByDecl.insert(std::make_pair(declid, wrap));
+            if (!res.second) {
+                delete wrap;
+                return res.first->second;
+            }
+        }
+        gWrapperHolder.push_back(wrap);
+    }
+    if (gAsyncWrappers) gWrapperCompiler.Enqueue(wrap);
     return wrap;
 }
 
@@ -189,6 +508,7 @@ static inline
 CallWrapper* new_CallWrapper(CallWrapper::DeclId_t fid, const std::string& n)
 {
     CallWrapper* wrap = new CallWrapper(fid, n);
+    std::lock_guard<std::mutex> lock(gWrapperMutex);
     gWrapperHolder.push_back(wrap);
     return wrap;
 }
@@ -204,23 +524,45 @@ static GlobalVarsIndices_t g_globalidx;
 Cppyy::TCppScope_t Cppyy::gGlobalScope = GLOBAL_HANDLE;
 
 // builtin types
-static std::set<std::string> g_builtins =
+static Cppyy::NameSet g_builtins =
     {"bool", "char", "signed char", "unsigned char", "int8_t", "uint8_t", "wchar_t",
      "short", "unsigned short", "int", "unsigned int", "long", "unsigned long",
      "long long", "unsigned long long",
      "float", "double", "long double", "void", "va_list"};
 
 // smart pointer types
-static std::set<std::string> gSmartPtrTypes =
+static Cppyy::NameSet gSmartPtrTypes =
     {"std::auto_ptr", "std::shared_ptr", "std::unique_ptr", "std::weak_ptr"};
 
 // to filter out ROOT names
-static std::set<std::string> gInitialNames;
-static std::set<std::string> gRootSOs;
+static Cppyy::NameSet gInitialNames;
+static Cppyy::NameSet gRootSOs;
+
+static void collect_all_cpp_names(Cppyy::TCppScope_t scope, std::set<std::string>& cppnames);
 
 // configuration
 static bool gEnableFastPath = true;
 
+// errors from generating wrappers are ignored (see GetCallFunc); this is done per
+// thread, through an error handler that forwards to the original one, as wrappers
+// are also compiled in the background, and gErrorIgnoreLevel is process-wide
+static thread_local bool gSilenceErrors = false;
+static ErrorHandlerFunc_t gPrevErrorHandler = nullptr;
+
+static void silenceable_error_handler(int level, Bool_t abort, const char* location, const char* msg)
+{
+    if (gSilenceErrors && level < kFatal)
+        return;
+    gPrevErrorHandler(level, abort, location, msg);
+}
+
+class SilencedErrors {
+    bool fPrevious;
+public:
+    SilencedErrors() : fPrevious(gSilenceErrors) { gSilenceErrors = true; }
+    ~SilencedErrors() { gSilenceErrors = fPrevious; }
+};
+
 
 // global initialization -----------------------------------------------------
 namespace {
@@ -297,6 +639,9 @@ public:
     // create the Cling interpreter lock
         TThread::Initialize();
 
+    // allow per-thread silencing of errors
+        gPrevErrorHandler = SetErrorHandler(silenceable_error_handler);
+
     // setup dummy holders for global and std namespaces
         assert(g_classrefs.size() == GLOBAL_HANDLE);
         g_name2classrefidx[""]     = GLOBAL_HANDLE;
@@ -312,15 +657,24 @@ public:
         g_globalidx[nullptr] = 0;
 
     // fill out the builtins
-        std::set<std::string> bi{g_builtins};
+        std::vector<std::string> bi;
+        for (const auto& entry : g_builtins)
+            bi.push_back(entry.fName);
         for (const auto& name : bi) {
             for (const char* a : {"*", "&", "*&", "[]", "*[]"})
                 g_builtins.insert(name+a);
         }
 
+    // let wrappers consume the Parameter array directly
+        gInterpreter->CallFunc_SetArgLayout(sizeof(Parameter),
+            offsetof(Parameter, fValue), offsetof(Parameter, fRef), offsetof(Parameter, fTypeCode));
+
     // disable fast path if requested
         if (std::getenv("CPPYY_DISABLE_FASTPATH")) gEnableFastPath = false;
 
+    // compile wrappers in the background ahead of first use if requested
+        if (std::getenv("CPPYY_ASYNC_WRAPPERS")) gAsyncWrappers = true;
+
     // set opt level (default to 2 if not given; Cling itself defaults to 0)
         int optLevel = 2;
         if (std::getenv("CPPYY_OPT_LEVEL")) optLevel = atoi(std::getenv("CPPYY_OPT_LEVEL"));
@@ -354,8 +708,9 @@ public:
         gROOT->GetListOfGlobals(true);             // force initialize
         gROOT->GetListOfGlobalFunctions(true);     // id.
         std::set<std::string> initial;
-        Cppyy::GetAllCppNames(GLOBAL_HANDLE, initial);
-        gInitialNames = initial;
+        collect_all_cpp_names(GLOBAL_HANDLE, initial);
+        for (const auto& name : initial)
+            gInitialNames.insert(name);
 
 #ifndef WIN32
         gRootSOs.insert("libCoreLegacy.so ");
@@ -375,6 +730,7 @@ public:
     }
 
     ~ApplicationStarter() {
+        gWrapperCompiler.Stop();
         for (auto wrap : gWrapperHolder)
             delete wrap;
         delete gExceptionHandler; gExceptionHandler = nullptr;
@@ -402,6 +758,37 @@ TFunction* m2f(Cppyy::TCppMethod_t method) {
     return wrap->fTF;
 }
 
+// memoization of per-method reflection information; results are computed w/o
+// holding the lock (computations may recurse, e.g. for lambda result types, and
+// call into the interpreter), so a race merely computes the same result twice
+static std::mutex gMethodMetaMutex;
+
+static inline
+CallWrapper::MetaCache& method_meta_nolock(Cppyy::TCppMethod_t method)
+{
+    CallWrapper* wrap = (CallWrapper*)method;
+    if (!wrap->fMeta) wrap->fMeta = new CallWrapper::MetaCache{};
+    return *wrap->fMeta;
+}
+
+template<typename S, typename C>
+static std::string memoized_method_meta(Cppyy::TCppMethod_t method, S select, C compute)
+{
+    {
+        std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+        const CallWrapper::MemoString& memo = select(method_meta_nolock(method));
+        if (memo.fSet) return memo.fValue;
+    }
+
+    std::string value = compute();
+
+    std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+    CallWrapper::MemoString& memo = select(method_meta_nolock(method));
+    memo.fValue = value;
+    memo.fSet = true;
+    return value;
+}
+
 /*
 static inline
 CallWrapper::DeclId_t m2d(Cppyy::TCppMethod_t method) {
@@ -559,9 +946,12 @@ std::string Cppyy::ResolveEnum(const std::string& enum_type)
 // The underlying type of a an enum may be any kind of integer.
 // Resolve that type via a workaround (note: this function assumes
 // that the enum_type name is a valid enum type name)
-    auto res = resolved_enum_types.find(enum_type);
-    if (res != resolved_enum_types.end())
-        return res->second;
+    {
+        std::shared_lock<ScopeMutex_t> lock(gScopeMutex);
+        auto res = resolved_enum_types.find(enum_type);
+        if (res)
+            return *res;
+    }
 
 // remove qualifiers and desugar the type before resolving
     std::string et_short = TClassEdit::ShortType(enum_type.c_str(), 1);
@@ -593,6 +983,7 @@ std::string Cppyy::ResolveEnum(const std::string& enum_type)
                     }
                 }
                 if (resugared.empty()) resugared = underlying_type;
+                std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
                 resolved_enum_types[enum_type] = resugared;
                 return resugared;
             }
@@ -609,6 +1000,7 @@ std::string Cppyy::ResolveEnum(const std::string& enum_type)
     bool isConst = enum_type.find("const ", 6) != std::string::npos;
     std::string restype = isConst ? "const " : "";
     restype += "internal_enum_type_t"+enum_type.substr((std::string::size_type)ipos+1, std::string::npos);
+    std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
     resolved_enum_types[enum_type] = restype;
     return restype;     // should default to some int variant
 }
@@ -643,15 +1035,22 @@ Cppyy::TCppScope_t Cppyy::GetScope(const std::string& sname)
 
 // Second, skip builtins before going through the more expensive steps of resolving
 // typedefs and looking up TClass
-    if (g_builtins.find(sname) != g_builtins.end())
+    if (g_builtins.contains(sname))
         return (TCppScope_t)0;
 
+// Third, names that failed before fail again, unless things changed since
+    if (is_scope_miss(sname))
+        return (TCppScope_t)0;
+
+    TInstrumentation::TTimer timer(TInstrumentation::kScopeLookup, sname.c_str());
+
 // TODO: scope_name should always be final already?
 // Resolve name fully before lookup to make sure all aliases point to the same scope
     std::string scope_name = ResolveName(sname);
     bool bHasAlias1 = sname != scope_name;
     if (bHasAlias1) {
-        result = find_memoized_scope(scope_name);
+        std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
+        result = find_memoized_scope_nolock(scope_name.data(), scope_name.size());
         if (result) {
             g_name2classrefidx[sname] = result;
             return result;
@@ -662,18 +1061,23 @@ Cppyy::TCppScope_t Cppyy::GetScope(const std::string& sname)
 // function returns) or forward declared, leading to a non-null TClass that is
 // otherwise invalid/unusable
     TClassRef cr(TClass::GetClass(scope_name.c_str(), true /* load */, true /* silent */));
-    if (!cr.GetClass())
+    if (!cr.GetClass()) {
+        add_scope_miss(sname);
+        TInstrumentation::Count(TInstrumentation::kScopeMiss, sname.c_str());
         return (TCppScope_t)0;
+    }
 
-// memoize found/created TClass
+// memoize found/created TClass; the lock is not held during the lookup above,
+// so check again whether another thread got here first
+    std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
     bool bHasAlias2 = cr->GetName() != scope_name;
-    if (bHasAlias2) {
-        result = find_memoized_scope(cr->GetName());
-        if (result) {
-            g_name2classrefidx[scope_name] = result;
-            if (bHasAlias1) g_name2classrefidx[sname] = result;
-            return result;
-        }
+    result = find_memoized_scope_nolock(scope_name.data(), scope_name.size());
+    if (!result && bHasAlias2)
+        result = find_memoized_scope_nolock(cr->GetName(), strlen(cr->GetName()));
+    if (result) {
+        g_name2classrefidx[scope_name] = result;
+        if (bHasAlias1) g_name2classrefidx[sname] = result;
+        return result;
     }
 
     ClassRefs_t::size_type sz = g_classrefs.size();
@@ -685,6 +1089,15 @@ Cppyy::TCppScope_t Cppyy::GetScope(const std::string& sname)
     return (TCppScope_t)sz;
 }
 
+void Cppyy::GetScopeMissStats(
+    unsigned long long& hits, unsigned long long& added, unsigned long long& flushes)
+{
+    std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
+    hits    = gScopeMissesHits;
+    added   = gScopeMissesAdded;
+    flushes = gScopeMissesFlushes;
+}
+
 bool Cppyy::IsTemplate(const std::string& template_name)
 {
     if ((bool)gInterpreter->CheckClassTemplate(template_name.c_str())) {
@@ -761,9 +1174,9 @@ Cppyy::TCppType_t Cppyy::GetActualClass(TCppType_t klass, TCppObject_t obj)
     TClass* clActual = cr->GetActualClass((void*)obj);
     // The additional check using TClass::GetClassInfo is to prevent returning classes of which the Interpreter has no info (see https://github.com/root-project/root/pull/16177)
     if (clActual && clActual != cr.GetClass() && clActual->GetClassInfo()) {
-        auto itt = g_name2classrefidx.find(clActual->GetName());
-        if (itt != g_name2classrefidx.end())
-            return (TCppType_t)itt->second;
+        TCppType_t actual = find_memoized_scope(clActual->GetName(), strlen(clActual->GetName()));
+        if (actual)
+            return actual;
         return (TCppType_t)GetScope(clActual->GetName());
     }
 
@@ -787,11 +1200,11 @@ size_t Cppyy::SizeOf(const std::string& type_name)
 
 bool Cppyy::IsBuiltin(const std::string& type_name)
 {
-    if (g_builtins.find(type_name) != g_builtins.end())
+    if (g_builtins.contains(type_name))
         return true;
 
     const std::string& tclean = TClassEdit::CleanType(type_name.c_str(), 1);
-    if (g_builtins.find(tclean) != g_builtins.end())
+    if (g_builtins.contains(tclean))
         return true;
 
     if (strstr(tclean.c_str(), "std::complex"))
@@ -864,15 +1277,28 @@ void Cppyy::Destruct(TCppType_t type, TCppObject_t instance)
 
 
 // method/function dispatching -----------------------------------------------
-static TInterpreter::CallFuncIFacePtr_t GetCallFunc(Cppyy::TCppMethod_t method, bool as_iface)
+static inline
+CallFunc_t* new_CallFunc(CallWrapper* wrap)
 {
-// TODO: method should be a callfunc, so that no mapping would be needed.
-    CallWrapper* wrap = (CallWrapper*)method;
-
     CallFunc_t* callf = gInterpreter->CallFunc_Factory();
     MethodInfo_t* meth = gInterpreter->MethodInfo_Factory(wrap->fDecl);
     gInterpreter->CallFunc_SetFunc(callf, meth);
     gInterpreter->MethodInfo_Delete(meth);
+    return callf;
+}
+
+static TInterpreter::CallFuncIFacePtr_t GetCallFunc(Cppyy::TCppMethod_t method, bool as_iface)
+{
+// TODO: method should be a callfunc, so that no mapping would be needed.
+    CallWrapper* wrap = (CallWrapper*)method;
+
+// a wrapper that failed to build will fail again; don't retry (this also keeps
+// the noexcept entry points from building it twice when falling back)
+    const unsigned char failed = as_iface ? CallWrapper::kFailedIface : CallWrapper::kFailedDirect;
+    if (wrap->fFailed & failed)
+        return TInterpreter::CallFuncIFacePtr_t{};
+
+    CallFunc_t* callf = new_CallFunc(wrap);
 
     if (!(callf && gInterpreter->CallFunc_IsValid(callf))) {
     // TODO: propagate this error to caller w/o use of Python C-API
@@ -882,16 +1308,20 @@ static TInterpreter::CallFuncIFacePtr_t GetCallFunc(Cppyy::TCppMethod_t method,
             wrap.fName, callString.c_str()); */
         std::cerr << "TODO: report unresolved function error to Python\n";
         if (callf) gInterpreter->CallFunc_Delete(callf);
+        wrap->fFailed |= failed;
         return TInterpreter::CallFuncIFacePtr_t{};
     }
+    wrap->fNoexcept = gInterpreter->CallFunc_IsNoexcept(callf) ? 1 : 0;
 
 // generate the wrapper and JIT it; ignore wrapper generation errors (will simply
 // result in a nullptr that is reported upstream if necessary; often, however,
 // there is a different overload available that will do)
-    auto oldErrLvl = gErrorIgnoreLevel;
-    gErrorIgnoreLevel = kFatal;
-    wrap->fFaceptr = gInterpreter->CallFunc_IFacePtr(callf, as_iface);
-    gErrorIgnoreLevel = oldErrLvl;
+    {
+        SilencedErrors silenced;
+        wrap->fFaceptr = gInterpreter->CallFunc_IFacePtr(callf, as_iface);
+    }
+    if (!(as_iface ? wrap->fFaceptr.fGeneric : wrap->fFaceptr.fDirect))
+        wrap->fFailed |= failed;
 
     gInterpreter->CallFunc_Delete(callf);   // does not touch IFacePtr
     return wrap->fFaceptr;
@@ -928,6 +1358,17 @@ void release_args(Parameter* args, size_t nargs)
     }
 }
 
+static inline
+bool is_noexcept(CallWrapper* wrap) {
+    if (wrap->fNoexcept < 0) {
+        CallFunc_t* callf = new_CallFunc(wrap);
+        wrap->fNoexcept = (callf && gInterpreter->CallFunc_IsValid(callf) &&
+            gInterpreter->CallFunc_IsNoexcept(callf)) ? 1 : 0;
+        if (callf) gInterpreter->CallFunc_Delete(callf);
+    }
+    return wrap->fNoexcept == 1;
+}
+
 static inline
 bool is_ready(CallWrapper* wrap, bool is_direct) {
     return (!is_direct && wrap->fFaceptr.fGeneric) || (is_direct && wrap->fFaceptr.fDirect);
@@ -941,27 +1382,33 @@ bool WrapperCall(Cppyy::TCppMethod_t method, size_t nargs, void* args_, void* se
     nargs = CALL_NARGS(nargs);
 
     CallWrapper* wrap = (CallWrapper*)method;
+    if (wrap->fAsyncState.load(std::memory_order_acquire) != CallWrapper::kIdle)
+        gWrapperCompiler.Claim(wrap);
     const TInterpreter::CallFuncIFacePtr_t& faceptr = \
         is_ready(wrap, is_direct) ? wrap->fFaceptr : GetCallFunc(method, !is_direct);
     if (!is_ready(wrap, is_direct))
         return false;        // happens with compilation error
 
     nargs = CALL_NARGS(nargs);
+    const bool nothrow = wrap->fNoexcept == 1;
     if (faceptr.fKind == TInterpreter::CallFuncIFacePtr_t::kGeneric) {
+        if (faceptr.fArgs) {
+        // wrapper variant that consumes the Parameter array as-is
+            CLING_CALL_GUARDED(nothrow, faceptr.fArgs(self, (int)nargs, (void**)args, result))
+            if (nargs) release_args(args, nargs);
+            return true;
+        }
+
         bool runRelease = false;
         const auto& fgen = is_direct ? faceptr.fDirect : faceptr.fGeneric;
         if (nargs <= SMALL_ARGS_N) {
             void* smallbuf[SMALL_ARGS_N];
             if (nargs) runRelease = copy_args(args, nargs, smallbuf);
-            CLING_CATCH_UNCAUGHT_
-            fgen(self, (int)nargs, smallbuf, result);
-            _CLING_CATCH_UNCAUGHT
+            CLING_CALL_GUARDED(nothrow, fgen(self, (int)nargs, smallbuf, result))
         } else {
             std::vector<void*> buf(nargs);
             runRelease = copy_args(args, nargs, buf.data());
-            CLING_CATCH_UNCAUGHT_
-            fgen(self, (int)nargs, buf.data(), result);
-            _CLING_CATCH_UNCAUGHT
+            CLING_CALL_GUARDED(nothrow, fgen(self, (int)nargs, buf.data(), result))
         }
         if (runRelease) release_args(args, nargs);
         return true;
@@ -1027,6 +1474,22 @@ CPPYY_IMP_CALL(F,  float        )
 CPPYY_IMP_CALL(D,  double       )
 CPPYY_IMP_CALL(LD, LongDouble_t )
 
+bool Cppyy::IsNoexcept(TCppMethod_t method)
+{
+    return is_noexcept((CallWrapper*)method);
+}
+
+bool Cppyy::CallNoexcept(
+    TCppMethod_t method, TCppObject_t self, size_t nargs, void* args, void* result)
+{
+// call without exception translation; returns false if the method can throw (in
+// which case it is not called) or if its wrapper fails to compile (which is
+// remembered, so the fallback to the regular call reports it without a rebuild)
+    if (!is_noexcept((CallWrapper*)method))
+        return false;
+    return WrapperCall(method, nargs, args, (void*)self, result);
+}
+
 void* Cppyy::CallR(TCppMethod_t method, TCppObject_t self, size_t nargs, void* args)
 {
     void* r = nullptr;
@@ -1077,6 +1540,105 @@ Cppyy::TCppObject_t Cppyy::CallO(TCppMethod_t method,
     return (TCppObject_t)0;
 }
 
+bool Cppyy::CallBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+    void** columns, const size_t* strides, size_t n, void* out, size_t out_stride)
+{
+// call method n times, with the k-th set of arguments at columns[i] + k*strides[i]
+// and the k-th result placed at out + k*out_stride; the loop runs in JITed code,
+// so there is only a single crossing of the C API for the full batch
+    CallWrapper* wrap = (CallWrapper*)method;
+    if (!wrap->fBatch) {
+        if (wrap->fFailed & CallWrapper::kFailedBatch)
+            return false;
+
+        CallFunc_t* callf = new_CallFunc(wrap);
+        if (!(callf && gInterpreter->CallFunc_IsValid(callf))) {
+            if (callf) gInterpreter->CallFunc_Delete(callf);
+            wrap->fFailed |= CallWrapper::kFailedBatch;
+            return false;
+        }
+
+        {
+            SilencedErrors silenced;
+            wrap->fBatch = gInterpreter->CallFunc_BatchIFacePtr(callf, true /* as_iface */);
+        }
+
+        gInterpreter->CallFunc_Delete(callf);   // does not touch the wrapper
+        if (!wrap->fBatch) {
+            wrap->fFailed |= CallWrapper::kFailedBatch;
+            return false;    // happens with compilation error
+        }
+    }
+
+    if (n) {
+        CLING_CALL_GUARDED(is_noexcept(wrap), wrap->fBatch((void**)selves, (int)nargs, columns,
+            strides, n, out, out_stride))
+    }
+    return true;
+}
+
+#define CPPYY_IMP_CALL_BATCH(typecode, rtype)                                \
+bool Cppyy::Call##typecode##Batch(TCppMethod_t method, TCppObject_t* selves, \
+    size_t nargs, void** columns, const size_t* strides, size_t n, rtype* out)\
+{                                                                            \
+    return CallBatch(method, selves, nargs, columns, strides, n, out, sizeof(rtype));\
+}
+
+CPPYY_IMP_CALL_BATCH(I,  int          )
+CPPYY_IMP_CALL_BATCH(L,  long         )
+CPPYY_IMP_CALL_BATCH(LL, Long64_t     )
+CPPYY_IMP_CALL_BATCH(F,  float        )
+CPPYY_IMP_CALL_BATCH(D,  double       )
+
+void Cppyy::PrepareWrappers(const std::vector<TCppMethod_t>& methods)
+{
+// generate the wrappers of all methods that do not have one yet and JIT them
+// in a single transaction (as opposed to one per method on first call); as in
+// GetCallFunc, failures are ignored here and reported when the method is called
+    std::vector<CallWrapper*> wraps; wraps.reserve(methods.size());
+    std::vector<CallFunc_t*> callfs; callfs.reserve(methods.size());
+    for (auto method : methods) {
+        CallWrapper* wrap = (CallWrapper*)method;
+        if (!wrap || is_ready(wrap, false))
+            continue;
+
+        CallFunc_t* callf = new_CallFunc(wrap);
+        if (!(callf && gInterpreter->CallFunc_IsValid(callf))) {
+            if (callf) gInterpreter->CallFunc_Delete(callf);
+            continue;
+        }
+
+        wrap->fNoexcept = gInterpreter->CallFunc_IsNoexcept(callf) ? 1 : 0;
+        wraps.push_back(wrap);
+        callfs.push_back(callf);
+    }
+
+    if (callfs.empty())
+        return;
+
+    std::vector<TInterpreter::CallFuncIFacePtr_t> faceptrs;
+    faceptrs.reserve(callfs.size());
+    {
+        SilencedErrors silenced;
+        gInterpreter->CallFunc_IFacePtrs(callfs, true /* as_iface */, faceptrs);
+    }
+
+    for (std::vector<CallWrapper*>::size_type i = 0; i < wraps.size(); ++i) {
+        if (i < faceptrs.size()) {
+            wraps[i]->fFaceptr = faceptrs[i];
+            if (!wraps[i]->fFaceptr.fGeneric)
+                wraps[i]->fFailed |= CallWrapper::kFailedIface;
+        }
+        gInterpreter->CallFunc_Delete(callfs[i]);   // does not touch IFacePtr
+    }
+}
+
+void Cppyy::WaitForWrappers()
+{
+// block until all wrappers queued for background compilation are done
+    if (gAsyncWrappers) gWrapperCompiler.Drain();
+}
+
 Cppyy::TCppFuncAddr_t Cppyy::GetFunctionAddress(TCppMethod_t method, bool check_enabled)
 {
     if (check_enabled && !gEnableFastPath) return (TCppFuncAddr_t)nullptr;
@@ -1183,10 +1745,12 @@ bool Cppyy::IsEnum(const std::string& type_name)
     std::string tn_short = TClassEdit::ShortType(type_name.c_str(), 1);
     if (tn_short.empty()) return false;
 
-    R__LOCKGUARD_CLING(gInterpreterMutex);
+// locks internally, and only exclusively on first lookup of a name
     if (gInterpreter->ClassInfo_IsEnum(tn_short.c_str()))
         return true;
 
+    R__LOCKGUARD_CLING(gInterpreterMutex);
+
     // ClassInfo_IsEnum may fail for shadowed enums
     TEnum* ee = nullptr;
 
@@ -1266,7 +1830,7 @@ std::string outer_no_template(const std::string& name)
     while ((obj = (type*)itr.Next())) {                                       \
         const char* nm = obj->GetName();                                      \
         if (nm && !(obj->Property() & (filter)) &&                            \
-                gInitialNames.find(nm) == gInitialNames.end())                \
+                !gInitialNames.contains(nm))                                  \
             cppnames.insert(nm);                                              \
     }}
 
@@ -1279,15 +1843,17 @@ void cond_add(Cppyy::TCppScope_t scope, const std::string& ns_scope,
 
     if (scope == GLOBAL_HANDLE) {
         std::string to_add = outer_no_template(name);
-        if (nofilter || gInitialNames.find(to_add) == gInitialNames.end())
-            cppnames.insert(outer_no_template(name));
+        if (nofilter || !gInitialNames.contains(to_add))
+            cppnames.insert(to_add);
     } else if (scope == STD_HANDLE) {
-        if (strncmp(name, "std::", 5) == 0) {
-            name += 5;
+    // as for other namespaces, only names qualified with it (the rootmap and
+    // the list of types also carry the names of other scopes)
+        if (strncmp(name, "std::", 5) != 0)
+            return;
+        name += 5;
 #ifdef __APPLE__
-            if (strncmp(name, "__1::", 5) == 0) name += 5;
+        if (strncmp(name, "__1::", 5) == 0) name += 5;
 #endif
-        }
         cppnames.insert(outer_no_template(name));
     } else {
         if (strncmp(name, ns_scope.c_str(), ns_scope.size()) == 0)
@@ -1295,16 +1861,14 @@ void cond_add(Cppyy::TCppScope_t scope, const std::string& ns_scope,
     }
 }
 
-void Cppyy::GetAllCppNames(TCppScope_t scope, std::set<std::string>& cppnames)
+static void collect_all_cpp_names(Cppyy::TCppScope_t scope, std::set<std::string>& cppnames)
 {
-// Collect all known names of C++ entities under scope. This is useful for IDEs
-// employing tab-completion, for example. Note that functions names need not be
-// unique as they can be overloaded.
+// Collect all known names of C++ entities under scope, from scratch.
     TClassRef& cr = type_from_handle(scope);
     if (scope != GLOBAL_HANDLE && !(cr.GetClass() && cr->Property()))
         return;
 
-    std::string ns_scope = GetFinalName(scope);
+    std::string ns_scope = Cppyy::GetFinalName(scope);
     if (scope != GLOBAL_HANDLE) ns_scope += "::";
 
 // add existing values from read rootmap files if within this scope
@@ -1315,7 +1879,7 @@ void Cppyy::GetAllCppNames(TCppScope_t scope, std::set<std::string>& cppnames)
         while ((ev = (TEnvRec*)itr.Next())) {
         // TEnv contains rootmap entries and user-side rootmap files may be already
         // loaded on startup. Thus, filter on file name rather than load time.
-            if (gRootSOs.find(ev->GetValue()) == gRootSOs.end())
+            if (!gRootSOs.contains(ev->GetValue()))
                 cond_add(scope, ns_scope, cppnames, ev->GetName(), true);
         }
     }
@@ -1362,7 +1926,7 @@ void Cppyy::GetAllCppNames(TCppScope_t scope, std::set<std::string>& cppnames)
         while ((obj = (TFunction*)itr.Next())) {
             const char* nm = obj->GetName();
         // skip templated functions, adding only the un-instantiated ones
-            if (nm && gInitialNames.find(nm) == gInitialNames.end())
+            if (nm && !gInitialNames.contains(nm))
                 cppnames.insert(nm);
         }
     }
@@ -1391,10 +1955,84 @@ void Cppyy::GetAllCppNames(TCppScope_t scope, std::set<std::string>& cppnames)
 #ifdef __APPLE__
 // special case for Apple, add version namespace '__1' entries to std
     if (scope == STD_HANDLE)
-        GetAllCppNames(GetScope("std::__1"), cppnames);
+        collect_all_cpp_names(Cppyy::GetScope("std::__1"), cppnames);
 #endif
 }
 
+// per-namespace name indices: built once from scratch, then kept up to date
+// with the names that the interpreter reports as declared (or added through
+// rootmap files) since, so that repeated queries (e.g. for tab-completion) do
+// not need to walk all classes, types, functions, etc. again
+namespace {
+
+struct NameIndex {
+    std::string fPrefix;             // scope name + "::", empty for global
+    std::set<std::string> fNames;
+};
+
+} // unnamed namespace
+
+static std::mutex gNameIndexMutex;
+static std::map<Cppyy::TCppScope_t, NameIndex> gNameIndices;
+
+static void update_name_indices_nolock()
+{
+    std::vector<std::pair<std::string, std::string>> added;
+    if (!gInterpreter->TakeNewDeclaredNames(added)) {
+        gNameIndices.clear();       // incomplete updates; rebuild on use
+        return;
+    }
+
+    for (auto& idx : gNameIndices) {
+        for (const auto& entry : added) {
+            if (entry.second.empty())
+                cond_add(idx.first, idx.second.fPrefix, idx.second.fNames, entry.first.c_str());
+            else if (!gRootSOs.contains(entry.second))
+                cond_add(idx.first, idx.second.fPrefix, idx.second.fNames, entry.first.c_str(), true);
+        }
+    }
+}
+
+void Cppyy::GetAllCppNames(TCppScope_t scope, std::set<std::string>& cppnames)
+{
+// Collect all known names of C++ entities under scope. This is useful for IDEs
+// employing tab-completion, for example. Note that functions names need not be
+// unique as they can be overloaded.
+    if (!IsNamespace(scope)) {
+    // classes are closed, so their (few) names are simply collected
+        collect_all_cpp_names(scope, cppnames);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(gNameIndexMutex);
+    update_name_indices_nolock();
+
+    auto idx = gNameIndices.find(scope);
+    if (idx == gNameIndices.end()) {
+        NameIndex& index = gNameIndices[scope];
+        if (scope != GLOBAL_HANDLE)
+            index.fPrefix = GetFinalName(scope) + "::";
+        collect_all_cpp_names(scope, index.fNames);
+        idx = gNameIndices.find(scope);
+    }
+
+// debugging aid: the incremental index should match a rebuild from scratch
+    if (std::getenv("CPPYY_VERIFY_NAME_INDEX")) {
+        std::set<std::string> fresh;
+        collect_all_cpp_names(scope, fresh);
+        if (fresh != idx->second.fNames) {
+            std::cerr << "Warning: name index of \"" << GetFinalName(scope)
+                      << "\" differs from a rebuild; rebuilt" << std::endl;
+            idx->second.fNames.swap(fresh);
+        }
+    }
+
+    if (cppnames.empty())
+        cppnames = idx->second.fNames;
+    else
+        cppnames.insert(idx->second.fNames.begin(), idx->second.fNames.end());
+}
+
 
 // class reflection information ----------------------------------------------
 std::vector<Cppyy::TCppScope_t> Cppyy::GetUsingNamespaces(TCppScope_t scope)
@@ -1591,8 +2229,9 @@ bool Cppyy::IsSubtype(TCppType_t derived, TCppType_t base)
 bool Cppyy::IsSmartPtr(TCppType_t klass)
 {
     TClassRef& cr = type_from_handle(klass);
-    const std::string& tn = cr->GetName();
-    if (gSmartPtrTypes.find(tn.substr(0, tn.find("<"))) != gSmartPtrTypes.end())
+    const char* tn = cr->GetName();
+    const char* tmpl = strchr(tn, '<');
+    if (gSmartPtrTypes.contains(tn, tmpl ? (size_t)(tmpl - tn) : strlen(tn)))
         return true;
     return false;
 }
@@ -1601,7 +2240,7 @@ bool Cppyy::GetSmartPtrInfo(
     const std::string& tname, TCppType_t* raw, TCppMethod_t* deref)
 {
     const std::string& rn = ResolveName(tname);
-    if (gSmartPtrTypes.find(rn.substr(0, rn.find("<"))) != gSmartPtrTypes.end()) {
+    if (gSmartPtrTypes.contains(rn.data(), std::min(rn.find('<'), rn.size()))) {
         if (!raw && !deref) return true;
 
         TClassRef& cr = type_from_handle(GetScope(tname));
@@ -1788,42 +2427,49 @@ std::string Cppyy::GetMethodMangledName(TCppMethod_t method)
     return "<unknown>";
 }
 
-std::string Cppyy::GetMethodResultType(TCppMethod_t method)
+static std::string method_result_type(Cppyy::TCppMethod_t method)
 {
-    if (method) {
-        TFunction* f = m2f(method);
-        if (f->ExtraProperty() & kIsConstructor)
-            return "constructor";
-        std::string restype = f->GetReturnTypeName();
-        // TODO: this is ugly; GetReturnTypeName() keeps typedefs, but may miss scopes
-        // for some reason; GetReturnTypeNormalizedName() has been modified to return
-        // the canonical type to guarantee correct namespaces. Sometimes typedefs look
-        // better, sometimes not, sometimes it's debatable (e.g. vector<int>::size_type).
-        // So, for correctness sake, GetReturnTypeNormalizedName() is used, except for a
-        // special case of uint8_t/int8_t that must propagate as their typedefs.
-        if (restype.find("int8_t") != std::string::npos)
-            return gInterpreter->ReduceType(restype);
-        restype = f->GetReturnTypeNormalizedName();
-        if (restype == "(lambda)") {
-            std::ostringstream s;
-            // TODO: what if there are parameters to the lambda?
-            s << "__cling_internal::FT<decltype("
-              << GetMethodFullName(method) << "(";
-            for (Cppyy::TCppIndex_t i = 0; i < Cppyy::GetMethodNumArgs(method); ++i) {
-                if (i != 0) s << ", ";
-                s << Cppyy::GetMethodArgType(method, i) << "{}";
-            }
-            s << "))>::F";
-            TClass* cl = TClass::GetClass(s.str().c_str());
-            if (cl) return cl->GetName();
-            // TODO: signal some type of error (or should that be upstream?
-        }
+    TFunction* f = m2f(method);
+    if (f->ExtraProperty() & kIsConstructor)
+        return "constructor";
+    std::string restype = f->GetReturnTypeName();
+    // TODO: this is ugly; GetReturnTypeName() keeps typedefs, but may miss scopes
+    // for some reason; GetReturnTypeNormalizedName() has been modified to return
+    // the canonical type to guarantee correct namespaces. Sometimes typedefs look
+    // better, sometimes not, sometimes it's debatable (e.g. vector<int>::size_type).
+    // So, for correctness sake, GetReturnTypeNormalizedName() is used, except for a
+    // special case of uint8_t/int8_t that must propagate as their typedefs.
+    if (restype.find("int8_t") != std::string::npos)
         return gInterpreter->ReduceType(restype);
+    restype = f->GetReturnTypeNormalizedName();
+    if (restype == "(lambda)") {
+        std::ostringstream s;
+        // TODO: what if there are parameters to the lambda?
+        s << "__cling_internal::FT<decltype("
+          << Cppyy::GetMethodFullName(method) << "(";
+        for (Cppyy::TCppIndex_t i = 0; i < Cppyy::GetMethodNumArgs(method); ++i) {
+            if (i != 0) s << ", ";
+            s << Cppyy::GetMethodArgType(method, i) << "{}";
+        }
+        s << "))>::F";
+        TClass* cl = TClass::GetClass(s.str().c_str());
+        if (cl) return cl->GetName();
+        // TODO: signal some type of error (or should that be upstream?
     }
-    return "<unknown>";
+    return gInterpreter->ReduceType(restype);
 }
 
-Cppyy::TCppIndex_t Cppyy::GetMethodNumArgs(TCppMethod_t method)
+std::string Cppyy::GetMethodResultType(TCppMethod_t method)
+{
+    if (method) {
+        return memoized_method_meta(method,
+            [](CallWrapper::MetaCache& m) -> CallWrapper::MemoString& { return m.fResultType; },
+            [method]() { return method_result_type(method); });
+    }
+    return "<unknown>";
+}
+
+Cppyy::TCppIndex_t Cppyy::GetMethodNumArgs(TCppMethod_t method)
 {
     if (method)
         return m2f(method)->GetNargs();
@@ -1849,48 +2495,116 @@ std::string Cppyy::GetMethodArgName(TCppMethod_t method, TCppIndex_t iarg)
     return "<unknown>";
 }
 
+static std::string method_arg_type(Cppyy::TCppMethod_t method, Cppyy::TCppIndex_t iarg)
+{
+    TFunction* f = m2f(method);
+    TMethodArg* arg = (TMethodArg*)f->GetListOfMethodArgs()->At((int)iarg);
+    std::string ft = arg->GetFullTypeName();
+    if (ft.rfind("enum ", 0) != std::string::npos) {   // special case to preserve 'enum' tag
+        std::string arg_type = arg->GetTypeNormalizedName();
+        return arg_type.insert(arg_type.rfind("const ", 0) == std::string::npos ? 0 : 6, "enum ");
+    } else if (g_builtins.contains(ft) || ft.find("int8_t") != std::string::npos)
+        return ft;       // do not resolve int8_t and uint8_t typedefs
+
+    return arg->GetTypeNormalizedName();
+}
+
 std::string Cppyy::GetMethodArgType(TCppMethod_t method, TCppIndex_t iarg)
 {
     if (method) {
-        TFunction* f = m2f(method);
-        TMethodArg* arg = (TMethodArg*)f->GetListOfMethodArgs()->At((int)iarg);
-        std::string ft = arg->GetFullTypeName();
-        if (ft.rfind("enum ", 0) != std::string::npos) {   // special case to preserve 'enum' tag
-            std::string arg_type = arg->GetTypeNormalizedName();
-            return arg_type.insert(arg_type.rfind("const ", 0) == std::string::npos ? 0 : 6, "enum ");
-        } else if (g_builtins.find(ft) != g_builtins.end() || ft.find("int8_t") != std::string::npos)
-            return ft;       // do not resolve int8_t and uint8_t typedefs
-
-        return arg->GetTypeNormalizedName();
+        return memoized_method_meta(method,
+            [iarg](CallWrapper::MetaCache& m) -> CallWrapper::MemoString& {
+                if (m.fArgTypes.size() <= iarg) m.fArgTypes.resize(iarg+1);
+                return m.fArgTypes[iarg];
+            },
+            [method, iarg]() { return method_arg_type(method, iarg); });
     }
     return "<unknown>";
 }
 
-Cppyy::TCppIndex_t Cppyy::CompareMethodArgType(TCppMethod_t method, TCppIndex_t iarg, const std::string &req_type)
+// qualified types for argument matching; the type infos are only needed to get
+// at the (opaque, but stable) qualified type pointers, so are deleted right away
+static inline
+void* qualtype_ptr(TypeInfo_t* ti)
 {
-    if (method) {
-        TFunction* f = m2f(method);
-        TMethodArg* arg = (TMethodArg *)f->GetListOfMethodArgs()->At((int)iarg);
-        void *argqtp = gInterpreter->TypeInfo_QualTypePtr(arg->GetTypeInfo());
+    void* qtp = gInterpreter->TypeInfo_QualTypePtr(ti);
+    gInterpreter->TypeInfo_Delete(ti);
+    return qtp;
+}
 
-        TypeInfo_t *reqti = gInterpreter->TypeInfo_Factory(req_type.c_str());
-        void *reqqtp = gInterpreter->TypeInfo_QualTypePtr(reqti);
+static CallWrapper::MemoQualTypes qualtypes_from(void* qtp, bool strip_pointer)
+{
+    CallWrapper::MemoQualTypes qt;
+    qt.fSet  = true;
+    qt.fType = qtp;
 
-        if (ArgSimilarityScore(argqtp, reqqtp) < 10) {
-            return ArgSimilarityScore(argqtp, reqqtp);
-        }
-        else { // Match using underlying types
-            if(gInterpreter->IsPointerType(argqtp))
-                argqtp = gInterpreter->TypeInfo_QualTypePtr(gInterpreter->GetPointerType(argqtp));
+    if (strip_pointer && gInterpreter->IsPointerType(qtp))
+        qtp = qualtype_ptr(gInterpreter->GetPointerType(qtp));
+
+// handles reference types and strips qualifiers
+    void* nonref = qualtype_ptr(gInterpreter->GetNonReferenceType(qtp));
+    qt.fBase = qualtype_ptr(gInterpreter->GetUnqualifiedType(nonref));
+    return qt;
+}
 
-            // Handles reference types and strips qualifiers
-            TypeInfo_t *arg_ul = gInterpreter->GetNonReferenceType(argqtp);
-            TypeInfo_t *req_ul = gInterpreter->GetNonReferenceType(reqqtp);
-            argqtp = gInterpreter->TypeInfo_QualTypePtr(gInterpreter->GetUnqualifiedType(gInterpreter->TypeInfo_QualTypePtr(arg_ul)));
-            reqqtp = gInterpreter->TypeInfo_QualTypePtr(gInterpreter->GetUnqualifiedType(gInterpreter->TypeInfo_QualTypePtr(req_ul)));
+static Cppyy::NameTable<CallWrapper::MemoQualTypes> gReqQualTypes;   // under gMethodMetaMutex
 
-            return ArgSimilarityScore(argqtp, reqqtp);
-        }
+static CallWrapper::MemoQualTypes arg_qualtypes(Cppyy::TCppMethod_t method, Cppyy::TCppIndex_t iarg)
+{
+    {
+        std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+        CallWrapper::MetaCache& meta = method_meta_nolock(method);
+        if (iarg < meta.fArgQualTypes.size() && meta.fArgQualTypes[iarg].fSet)
+            return meta.fArgQualTypes[iarg];
+    }
+
+    TFunction* f = m2f(method);
+    TMethodArg* arg = (TMethodArg*)f->GetListOfMethodArgs()->At((int)iarg);
+    CallWrapper::MemoQualTypes qt =
+        qualtypes_from(gInterpreter->TypeInfo_QualTypePtr(arg->GetTypeInfo()), true /* strip pointer */);
+
+    std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+    CallWrapper::MetaCache& meta = method_meta_nolock(method);
+    if (meta.fArgQualTypes.size() <= iarg) meta.fArgQualTypes.resize(iarg+1);
+    meta.fArgQualTypes[iarg] = qt;
+    return qt;
+}
+
+static CallWrapper::MemoQualTypes req_qualtypes(const std::string& req_type)
+{
+    {
+        std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+        CallWrapper::MemoQualTypes* qt = gReqQualTypes.find(req_type);
+        if (qt) return *qt;
+    }
+
+    TypeInfo_t* ti = gInterpreter->TypeInfo_Factory(req_type.c_str());
+    bool valid = gInterpreter->TypeInfo_IsValid(ti);
+    void* qtp = gInterpreter->TypeInfo_QualTypePtr(ti);
+    gInterpreter->TypeInfo_Delete(ti);
+    CallWrapper::MemoQualTypes qt = qualtypes_from(qtp, false);
+
+// failed lookups are not memoized, as the type may be declared later on
+    if (!valid || !qt.fType)
+        return qt;
+
+    std::lock_guard<std::mutex> lock(gMethodMetaMutex);
+    gReqQualTypes[req_type] = qt;
+    return qt;
+}
+
+Cppyy::TCppIndex_t Cppyy::CompareMethodArgType(TCppMethod_t method, TCppIndex_t iarg, const std::string &req_type)
+{
+    if (method) {
+        CallWrapper::MemoQualTypes argqt = arg_qualtypes(method, iarg);
+        CallWrapper::MemoQualTypes reqqt = req_qualtypes(req_type);
+
+        TCppIndex_t score = ArgSimilarityScore(argqt.fType, reqqt.fType);
+        if (score < 10)
+            return score;
+
+    // match using underlying types
+        return ArgSimilarityScore(argqt.fBase, reqqt.fBase);
     }
     return INT_MAX; // Method is not valid
 }
@@ -1908,14 +2622,14 @@ std::string Cppyy::GetMethodArgDefault(TCppMethod_t method, TCppIndex_t iarg)
     return "";
 }
 
-std::string Cppyy::GetMethodSignature(TCppMethod_t method, bool show_formalargs, TCppIndex_t maxargs)
+static std::string method_signature(Cppyy::TCppMethod_t method, bool show_formalargs, Cppyy::TCppIndex_t maxargs)
 {
     TFunction* f = m2f(method);
     if (f) {
         std::ostringstream sig;
         sig << "(";
         int nArgs = f->GetNargs();
-        if (maxargs != (TCppIndex_t)-1) nArgs = std::min(nArgs, (int)maxargs);
+        if (maxargs != (Cppyy::TCppIndex_t)-1) nArgs = std::min(nArgs, (int)maxargs);
         for (int iarg = 0; iarg < nArgs; ++iarg) {
             TMethodArg* arg = (TMethodArg*)f->GetListOfMethodArgs()->At(iarg);
             sig << arg->GetFullTypeName();
@@ -1933,20 +2647,53 @@ std::string Cppyy::GetMethodSignature(TCppMethod_t method, bool show_formalargs,
     return "<unknown>";
 }
 
-std::string Cppyy::GetMethodPrototype(TCppScope_t scope, TCppMethod_t method, bool show_formalargs)
+std::string Cppyy::GetMethodSignature(TCppMethod_t method, bool show_formalargs, TCppIndex_t maxargs)
+{
+    if (!method)
+        return "<unknown>";
+
+// only full signatures are memoized (partial ones are rare and used for errors)
+    if (maxargs != (TCppIndex_t)-1 && maxargs < GetMethodNumArgs(method))
+        return method_signature(method, show_formalargs, maxargs);
+
+    return memoized_method_meta(method,
+        [show_formalargs](CallWrapper::MetaCache& m) -> CallWrapper::MemoString& {
+            return m.fSignature[show_formalargs];
+        },
+        [method, show_formalargs]() { return method_signature(method, show_formalargs, (TCppIndex_t)-1); });
+}
+
+static std::string method_prototype(Cppyy::TCppScope_t scope, Cppyy::TCppMethod_t method, bool show_formalargs)
 {
-    std::string scName = GetScopedFinalName(scope);
+    std::string scName = Cppyy::GetScopedFinalName(scope);
     TFunction* f = m2f(method);
     if (f) {
         std::ostringstream sig;
         sig << f->GetReturnTypeName() << " "
             << scName << "::" << f->GetName();
-        sig << GetMethodSignature(method, show_formalargs);
+        sig << Cppyy::GetMethodSignature(method, show_formalargs);
         return sig.str();
     }
     return "<unknown>";
 }
 
+std::string Cppyy::GetMethodPrototype(TCppScope_t scope, TCppMethod_t method, bool show_formalargs)
+{
+    if (!method)
+        return "<unknown>";
+
+// the scope is almost always the declaring one, so only the last one is kept
+    return memoized_method_meta(method,
+        [scope, show_formalargs](CallWrapper::MetaCache& m) -> CallWrapper::MemoString& {
+            if (m.fProtoScope != (size_t)scope) {
+                m.fProtoScope = (size_t)scope;
+                m.fPrototype[0] = m.fPrototype[1] = CallWrapper::MemoString{};
+            }
+            return m.fPrototype[show_formalargs];
+        },
+        [scope, method, show_formalargs]() { return method_prototype(scope, method, show_formalargs); });
+}
+
 bool Cppyy::IsConstMethod(TCppMethod_t method)
 {
     if (method) {
@@ -2341,13 +3088,16 @@ std::string Cppyy::GetDatamemberType(TCppScope_t scope, TCppIndex_t idata)
             fulls << fullType << "@" << (void*)declid;
             fullType = fulls.str();
 
-            if (g_name2classrefidx.find(fullType) == g_name2classrefidx.end()) {
+            if (!find_memoized_scope(fullType)) {
                 ClassInfo_t* ci = gInterpreter->ClassInfo_Factory(declid);
                 TClass* cl = gInterpreter->GenerateTClass(ci, kTRUE /* silent */);
                 gInterpreter->ClassInfo_Delete(ci);
                 if (cl) cl->SetName(fullType.c_str());
-                g_name2classrefidx[fullType] = g_classrefs.size();
-                g_classrefs.emplace_back(cl);
+                std::lock_guard<ScopeMutex_t> lock(gScopeMutex);
+                if (!find_memoized_scope_nolock(fullType.data(), fullType.size())) {
+                    g_name2classrefidx[fullType] = g_classrefs.size();
+                    g_classrefs.push_back(TClassRef(cl));
+                }
             }
         }
         return fullType;
@@ -2601,6 +3351,754 @@ long long Cppyy::GetEnumDataValue(TCppEnum_t etype, TCppIndex_t idata)
 }
 
 
+// bulk reflection information -----------------------------------------------
+namespace {
+
+// Collects a scope description with all pointers stored as offsets (strings
+// into the string pool, arrays as element indices), then lays everything out
+// in a single block and turns those offsets into pointers into that block.
+class ScopeDescBuilder {
+public:
+    const char* str(const std::string& s) {
+        size_t off = fStrings.size();
+        fStrings.append(s.c_str(), s.size()+1);
+        return (const char*)off;
+    }
+
+    Cppyy::TCppScopeDesc_t* finalize(const Cppyy::TCppScopeDesc_t& desc);
+
+public:
+    std::vector<const char*>                fBases;
+    std::vector<Cppyy::TCppMethodDesc_t>    fMethods;
+    std::vector<Cppyy::TCppArgDesc_t>       fArgs;
+    std::vector<Cppyy::TCppDataDesc_t>      fDatamembers;
+    std::vector<Cppyy::TCppEnumDesc_t>      fEnums;
+    std::vector<Cppyy::TCppEnumConstDesc_t> fConstants;
+    std::string                             fStrings;
+};
+
+template<typename T>
+inline size_t desc_section(size_t& offset, const std::vector<T>& v)
+{
+    const size_t align = alignof(std::max_align_t);
+    size_t start = (offset + align - 1) & ~(align - 1);
+    offset = start + v.size()*sizeof(T);
+    return start;
+}
+
+Cppyy::TCppScopeDesc_t* ScopeDescBuilder::finalize(const Cppyy::TCppScopeDesc_t& desc)
+{
+    size_t total = sizeof(Cppyy::TCppScopeDesc_t);
+    size_t obases   = desc_section(total, fBases);
+    size_t omethods = desc_section(total, fMethods);
+    size_t oargs    = desc_section(total, fArgs);
+    size_t odata    = desc_section(total, fDatamembers);
+    size_t oenums   = desc_section(total, fEnums);
+    size_t oconsts  = desc_section(total, fConstants);
+    size_t ostrings = total;
+    total += fStrings.size();
+
+    char* block = (char*)malloc(total);
+    if (!block)
+        return nullptr;
+
+    const char* strings = block + ostrings;
+    memcpy(block + ostrings, fStrings.data(), fStrings.size());
+    auto fix = [strings](const char*& s) { s = strings + (size_t)s; };
+
+    const char** bases = (const char**)(block + obases);
+    for (size_t i = 0; i < fBases.size(); ++i) {
+        bases[i] = fBases[i];
+        fix(bases[i]);
+    }
+
+    Cppyy::TCppArgDesc_t* args = (Cppyy::TCppArgDesc_t*)(block + oargs);
+    for (size_t i = 0; i < fArgs.size(); ++i) {
+        args[i] = fArgs[i];
+        fix(args[i].fName); fix(args[i].fType); fix(args[i].fDefault);
+    }
+
+    Cppyy::TCppMethodDesc_t* methods = (Cppyy::TCppMethodDesc_t*)(block + omethods);
+    for (size_t i = 0; i < fMethods.size(); ++i) {
+        methods[i] = fMethods[i];
+        fix(methods[i].fName); fix(methods[i].fResultType);
+        methods[i].fArgs = args + (size_t)methods[i].fArgs;
+    }
+
+    Cppyy::TCppDataDesc_t* data = (Cppyy::TCppDataDesc_t*)(block + odata);
+    for (size_t i = 0; i < fDatamembers.size(); ++i) {
+        data[i] = fDatamembers[i];
+        fix(data[i].fName); fix(data[i].fType);
+    }
+
+    Cppyy::TCppEnumConstDesc_t* consts = (Cppyy::TCppEnumConstDesc_t*)(block + oconsts);
+    for (size_t i = 0; i < fConstants.size(); ++i) {
+        consts[i] = fConstants[i];
+        fix(consts[i].fName);
+    }
+
+    Cppyy::TCppEnumDesc_t* enums = (Cppyy::TCppEnumDesc_t*)(block + oenums);
+    for (size_t i = 0; i < fEnums.size(); ++i) {
+        enums[i] = fEnums[i];
+        fix(enums[i].fName);
+        enums[i].fConstants = consts + (size_t)enums[i].fConstants;
+    }
+
+    Cppyy::TCppScopeDesc_t* result = (Cppyy::TCppScopeDesc_t*)block;
+    *result = desc;
+    fix(result->fName); fix(result->fScopedName);
+    result->fNBases       = (unsigned int)fBases.size();
+    result->fBases        = bases;
+    result->fNMethods     = (unsigned int)fMethods.size();
+    result->fMethods      = methods;
+    result->fNDatamembers = (unsigned int)fDatamembers.size();
+    result->fDatamembers  = data;
+    result->fNEnums       = (unsigned int)fEnums.size();
+    result->fEnums        = enums;
+
+    return result;
+}
+
+} // unnamed namespace
+
+Cppyy::TCppScopeDesc_t* Cppyy::DescribeScope(TCppScope_t scope)
+{
+// Describe a class or namespace in one go, with the same results as the per-item
+// calls above. As there, methods and data members of namespaces are left to lazy
+// lookup and are thus not included.
+    if (scope == GLOBAL_HANDLE)
+        return nullptr;
+
+    TClassRef& cr = type_from_handle(scope);
+    if (!cr.GetClass())
+        return nullptr;
+
+    ScopeDescBuilder b;
+    TCppScopeDesc_t desc{};
+    desc.fScope      = scope;
+    desc.fName       = b.str(GetFinalName(scope));
+    desc.fScopedName = b.str(cr->GetName());
+    desc.fSize       = SizeOf(scope);
+
+    const bool isns = cr->Property() & kIsNamespace;
+    if (isns)
+        desc.fProperty |= kDescNamespace;
+    else {
+        if (IsAbstract(scope))             desc.fProperty |= kDescAbstract;
+        if (IsAggregate(scope))            desc.fProperty |= kDescAggregate;
+        if (IsDefaultConstructable(scope)) desc.fProperty |= kDescDefaultCtor;
+        if (HasVirtualDestructor(scope))   desc.fProperty |= kDescVirtualDtor;
+        if (HasComplexHierarchy(scope))    desc.fProperty |= kDescComplex;
+        if (IsSmartPtr(scope))             desc.fProperty |= kDescSmartPtr;
+    }
+
+    TCppIndex_t nbases = GetNumBases(scope);
+    b.fBases.reserve(nbases);
+    for (TCppIndex_t ibase = 0; ibase < nbases; ++ibase)
+        b.fBases.push_back(b.str(GetBaseName(scope, ibase)));
+
+    TCppIndex_t nmethods = GetNumMethods(scope);
+    b.fMethods.reserve(nmethods);
+    for (TCppIndex_t imeth = 0; imeth < nmethods; ++imeth) {
+        TCppMethodDesc_t md{};
+        md.fMethod = GetMethod(scope, imeth);
+        if (!md.fMethod) {       // keep indices aligned with GetMethod()
+            md.fName = md.fResultType = b.str("");
+            md.fArgs = (TCppArgDesc_t*)b.fArgs.size();
+            b.fMethods.push_back(md);
+            continue;
+        }
+
+        TFunction* f = m2f(md.fMethod);
+        md.fName       = b.str(GetMethodName(md.fMethod));
+        md.fResultType = b.str(GetMethodResultType(md.fMethod));
+        md.fNArgs      = (unsigned int)f->GetNargs();
+        md.fReqArgs    = (unsigned int)(f->GetNargs() - f->GetNargsOpt());
+
+        Long_t prop = f->Property(), eprop = f->ExtraProperty();
+        if (prop & kIsPublic)       md.fProperty |= kDescPublic;
+        if (prop & kIsProtected)    md.fProperty |= kDescProtected;
+        if (prop & kIsStatic)       md.fProperty |= kDescStatic;
+        if (prop & kIsConstMethod)  md.fProperty |= kDescConst;
+        if (prop & kIsExplicit)     md.fProperty |= kDescExplicit;
+        if (eprop & kIsConstructor) md.fProperty |= kDescConstructor;
+        if (eprop & kIsDestructor)  md.fProperty |= kDescDestructor;
+
+        md.fArgs = (TCppArgDesc_t*)b.fArgs.size();
+        for (TCppIndex_t iarg = 0; iarg < (TCppIndex_t)md.fNArgs; ++iarg) {
+            TCppArgDesc_t ad;
+            ad.fName    = b.str(GetMethodArgName(md.fMethod, iarg));
+            ad.fType    = b.str(GetMethodArgType(md.fMethod, iarg));
+            ad.fDefault = b.str(GetMethodArgDefault(md.fMethod, iarg));
+            b.fArgs.push_back(ad);
+        }
+        b.fMethods.push_back(md);
+    }
+
+    TCppIndex_t ndata = GetNumDatamembers(scope);
+    b.fDatamembers.reserve(ndata);
+    for (TCppIndex_t idata = 0; idata < ndata; ++idata) {
+        TDataMember* m = (TDataMember*)cr->GetListOfDataMembers()->At((int)idata);
+        TCppDataDesc_t dd{};
+        dd.fName = b.str(m->GetName());
+        dd.fType = b.str(GetDatamemberType(scope, idata));
+
+        Long_t prop = m->Property();
+        if (prop & kIsPublic)        dd.fProperty |= kDescPublic;
+        if (prop & kIsProtected)     dd.fProperty |= kDescProtected;
+        if (prop & kIsStatic)        dd.fProperty |= kDescStatic;
+        if (IsConstData(scope, idata)) dd.fProperty |= kDescConst;
+        if (IsEnumData(scope, idata))  dd.fProperty |= kDescEnumData;
+
+    // the offset of static data may require the interpreter to load the variable,
+    // which fails for non-public data, so leave that to explicit requests
+        dd.fOffset = ((prop & kIsPublic) || !(prop & kIsStatic)) ? \
+            GetDatamemberOffset(scope, idata) : (intptr_t)-1;
+        b.fDatamembers.push_back(dd);
+    }
+
+    TCollection* enums = cr->GetListOfEnums(true);
+    if (enums) {
+        TIter ienum{enums};
+        TEnum* e = nullptr;
+        while ((e = (TEnum*)ienum.Next())) {
+            TCppEnumDesc_t ed{};
+            ed.fEnum = (TCppEnum_t)e;
+            ed.fName = b.str(e->GetName());
+            ed.fConstants = (TCppEnumConstDesc_t*)b.fConstants.size();
+            TIter iconst{e->GetConstants()};
+            TEnumConstant* ecst = nullptr;
+            while ((ecst = (TEnumConstant*)iconst.Next())) {
+                b.fConstants.push_back({b.str(ecst->GetName()), (long long)ecst->GetValue()});
+                ed.fNConstants += 1;
+            }
+            b.fEnums.push_back(ed);
+        }
+    }
+
+    return b.finalize(desc);
+}
+
+
+// instrumentation -----------------------------------------------------------
+bool Cppyy::EnableInstrumentation(bool enable)
+{
+    return TInstrumentation::SetEnabled(enable);
+}
+
+void Cppyy::ResetInstrumentation()
+{
+    TInstrumentation::Reset();
+}
+
+std::string Cppyy::GetInstrumentationReport()
+{
+    return TInstrumentation::Report();
+}
+
+
+// preloading (warm-up before fork()) ----------------------------------------
+#ifndef WIN32
+// fork() only duplicates the calling thread, so all locks that another thread
+// could hold are taken before and released after (in both parent and child);
+// order follows the nesting elsewhere: the name index mutex is held while
+// calling into the interpreter, which may (de)compress; all others are leaves
+static void lock_heap_files();        // with the shared-memory heaps, below
+static void unlock_heap_files();
+
+static void fork_prepare()
+{
+    gWrapperCompiler.ForkPrepare();
+    gNameIndexMutex.lock();
+    if (gInterpreterMutex) gInterpreterMutex->Lock();
+    R__ZipForkPrepare();
+    gScopeMutex.lock();
+    gMethodMetaMutex.lock();
+    gWrapperMutex.lock();
+    lock_heap_files();
+    TInstrumentation::ForkPrepare();
+}
+
+static void fork_release(bool child)
+{
+    TInstrumentation::ForkRelease();
+    unlock_heap_files();
+    gWrapperMutex.unlock();
+    gMethodMetaMutex.unlock();
+    gScopeMutex.unlock();
+    if (child) R__ZipForkChild(); else R__ZipForkParent();
+    if (gInterpreterMutex) gInterpreterMutex->UnLock();
+    gNameIndexMutex.unlock();
+    gWrapperCompiler.ForkRelease();
+}
+
+static void fork_parent() { fork_release(false); }
+static void fork_child()  { fork_release(true); }
+#endif
+
+bool Cppyy::EnableForkSafety()
+{
+// opt-in: with the handlers installed, fork() waits for any thread that uses the
+// interpreter, so the forking thread should not hold locks (e.g. the GIL) that
+// such a thread could be waiting on
+#ifndef WIN32
+    static const bool installed =
+        pthread_atfork(&fork_prepare, &fork_parent, &fork_child) == 0;
+    return installed;
+#else
+    return false;
+#endif
+}
+
+bool Cppyy::Preload(const std::vector<std::string>& libraries,
+    const std::vector<std::string>& scopes, bool wrappers)
+{
+// front-load the work that is otherwise done on first use, so that processes
+// forked afterwards share it (copy-on-write) instead of each repeating it
+    bool ok = true;
+    for (const auto& lib : libraries) {
+        int result = gSystem->Load(lib.c_str());
+        if (!(result == 0 /* success */ || result == 1 /* already loaded */))
+            ok = false;
+    }
+
+    std::vector<TCppMethod_t> methods;
+    for (const auto& name : scopes) {
+        TCppScope_t scope = GetScope(name);
+        if (!scope) {
+            ok = false;
+            continue;
+        }
+
+        if (!wrappers || IsNamespace(scope))
+            continue;
+
+        TCppIndex_t nmeths = GetNumMethods(scope);
+        for (TCppIndex_t imeth = 0; imeth < nmeths; ++imeth)
+            methods.push_back(GetMethod(scope, imeth));
+    }
+
+    if (!methods.empty()) {
+        PrepareWrappers(methods);
+        WaitForWrappers();          // picks up any that were queued meanwhile
+    }
+
+    EnableForkSafety();
+    return ok;
+}
+
+
+// serialization --------------------------------------------------------------
+// Objects are streamed with TClass::Streamer(), which for all classes without a
+// custom streamer applies the compiled TStreamerInfoActions sequences. The
+// buffers are per thread and kept between calls, so that once they have grown
+// to the largest object seen, (de)serializing does not allocate.
+namespace {
+
+struct SerializationBuffers {
+    TBufferFile fWrite{TBuffer::kWrite};
+    TBufferFile fRead{TBuffer::kRead};
+};
+
+SerializationBuffers& serialization_buffers()
+{
+    static thread_local SerializationBuffers sBuffers;
+    return sBuffers;
+}
+
+} // unnamed namespace
+
+bool Cppyy::Serialize(TCppType_t type, TCppObject_t obj, char** buf, size_t* len)
+{
+    TClass* cl = type_from_handle(type).GetClass();
+    if (!cl || !obj || !buf || !len)
+        return false;
+
+    TBufferFile& b = serialization_buffers().fWrite;
+    b.Reset();
+    cl->Streamer((void*)obj, b);
+
+    size_t nbytes = (size_t)b.Length();
+    if (*buf) {
+        if (*len < nbytes) {
+            *len = nbytes;          // tells the caller the required size
+            return false;
+        }
+        memcpy(*buf, b.Buffer(), nbytes);
+    } else
+        *buf = b.Buffer();
+    *len = nbytes;
+    return true;
+}
+
+Cppyy::TCppObject_t Cppyy::Deserialize(TCppType_t type, const char* buf, size_t len, void* arena)
+{
+    TClass* cl = type_from_handle(type).GetClass();
+    if (!cl || !buf || (size_t)INT_MAX < len)
+        return (TCppObject_t)0;
+
+    void* obj = arena ? cl->New(arena, TClass::kRealNew) : cl->New(TClass::kRealNew);
+    if (!obj)
+        return (TCppObject_t)0;
+
+    TBufferFile& b = serialization_buffers().fRead;
+    b.SetBuffer((void*)buf, (UInt_t)len, kFALSE);
+    b.ResetMap();
+    cl->Streamer(obj, b);
+
+// a mismatch means the buffer was not written for this type
+    if ((size_t)b.Length() != len) {
+        cl->Destructor(obj, arena != nullptr /* dtor only */);
+        return (TCppObject_t)0;
+    }
+    return (TCppObject_t)obj;
+}
+
+
+// shared-memory heaps ---------------------------------------------------------
+// The heaps are managed by the mapped-malloc allocator from clib (part of
+// libCoreLegacy, but its header is not installed). That allocator is not thread
+// safe and the heap may be used by several processes, so all calls into it are
+// serialized with a process-shared lock that lives in the heap itself, next to
+// the table of named objects. The table stores type names rather than handles,
+// as the latter are only meaningful in the process that created them.
+namespace {
+
+// the heap that cppyy::heap_allocator<T> allocates from on this thread
+thread_local Cppyy::TCppHeap_t gCurrentHeap = nullptr;
+
+} // unnamed namespace
+
+#ifndef WIN32
+extern "C" {
+    void* mmalloc(void*, size_t);
+    void  mfree(void*, void*);
+    void* mmalloc_attach(int, void*, int);
+    void* mmalloc_detach(void*);
+    int   mmalloc_share(void*);
+    int   mmalloc_setkey(void*, int, void*);
+    void* mmalloc_getkey(void*, int);
+}
+
+namespace {
+
+const char kHeapMagic[] = "cppyyhp";
+
+struct HeapEntry {
+    HeapEntry* fNext;
+    void*      fObject;
+    char*      fName;           // both stored in the same block as the entry
+    char*      fType;
+};
+
+struct HeapHeader {
+    char            fMagic[sizeof(kHeapMagic)];
+    pthread_mutex_t fLock;
+    HeapEntry*      fEntries;
+};
+
+class HeapLock {
+    pthread_mutex_t* fLock;
+public:
+    HeapLock(HeapHeader* hdr) : fLock(&hdr->fLock) {
+#ifdef __linux__
+    // a process that died while holding the lock, left the heap consistent in
+    // all but the most unlucky cases; carry on rather than block forever
+        if (pthread_mutex_lock(fLock) == EOWNERDEAD)
+            pthread_mutex_consistent(fLock);
+#else
+        pthread_mutex_lock(fLock);
+#endif
+    }
+    ~HeapLock() { pthread_mutex_unlock(fLock); }
+};
+
+// the file descriptors of the heaps attached by this process
+std::map<Cppyy::TCppHeap_t, int> gHeapFiles;
+std::mutex gHeapFilesMutex;
+
+inline HeapHeader* heap_header(Cppyy::TCppHeap_t heap)
+{
+    return heap ? (HeapHeader*)mmalloc_getkey(heap, 0) : nullptr;
+}
+
+} // unnamed namespace
+
+static void lock_heap_files()   { gHeapFilesMutex.lock(); }
+static void unlock_heap_files() { gHeapFilesMutex.unlock(); }
+
+namespace {
+
+Cppyy::TCppHeap_t register_heap(void* md, int fd)
+{
+    std::lock_guard<std::mutex> lock(gHeapFilesMutex);
+    gHeapFiles[md] = fd;
+    return md;
+}
+
+// allocator for containers in shared-memory heaps (see HeapConstruct); declared
+// on first use of a heap, rather than at startup, as few programs use them
+std::once_flag gHeapAllocatorDeclared;
+
+void declare_heap_allocator()
+{
+    std::call_once(gHeapAllocatorDeclared, []() {
+        gInterpreter->Declare(
+            "extern \"C\" { void* cppyy_current_heap();"
+            " void* cppyy_heap_allocate(void*, size_t); void cppyy_heap_deallocate(void*, void*); }\n"
+            "namespace cppyy { template<class T> struct heap_allocator {"
+            "  typedef T value_type; void* fHeap;"
+            "  heap_allocator() noexcept : fHeap(cppyy_current_heap()) {}"
+            "  explicit heap_allocator(void* heap) noexcept : fHeap(heap) {}"
+            "  template<class U> heap_allocator(const heap_allocator<U>& a) noexcept : fHeap(a.fHeap) {}"
+            "  T* allocate(size_t n) {"
+            "    void* p = fHeap ? cppyy_heap_allocate(fHeap, n*sizeof(T)) : ::operator new(n*sizeof(T));"
+            "    if (!p) throw std::bad_alloc{};"
+            "    return (T*)p; }"
+            "  void deallocate(T* p, size_t) noexcept {"
+            "    if (fHeap) cppyy_heap_deallocate(fHeap, p); else ::operator delete(p); } };"
+            " template<class T, class U>"
+            " bool operator==(const heap_allocator<T>& a, const heap_allocator<U>& b) { return a.fHeap == b.fHeap; }"
+            " template<class T, class U>"
+            " bool operator!=(const heap_allocator<T>& a, const heap_allocator<U>& b) { return a.fHeap != b.fHeap; } }");
+    });
+}
+
+// restores the current heap on scope exit, also when the constructor throws
+class CurrentHeap {
+    Cppyy::TCppHeap_t fPrevious;
+public:
+    CurrentHeap(Cppyy::TCppHeap_t heap) : fPrevious(gCurrentHeap) { gCurrentHeap = heap; }
+    ~CurrentHeap() { gCurrentHeap = fPrevious; }
+};
+
+} // unnamed namespace
+
+Cppyy::TCppHeap_t Cppyy::CreateSharedHeap(const std::string& path, size_t size, void* base)
+{
+    if (size < sizeof(HeapHeader) || (size_t)INT_MAX < size)
+        return nullptr;
+    declare_heap_allocator();
+
+// set up the heap under a temporary name, so that it is complete once visible
+    std::string tmp = path + ".XXXXXX";
+    int fd = mkstemp(&tmp[0]);
+    if (fd < 0)
+        return nullptr;
+
+// map the full size up front, as a shared heap can not grow
+    void* md = mmalloc_attach(fd, base, (int)size);
+    HeapHeader* hdr = nullptr;
+    if (md && mmalloc_share(md))
+        hdr = (HeapHeader*)mmalloc(md, sizeof(HeapHeader));
+    if (hdr) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef __linux__
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+        pthread_mutex_init(&hdr->fLock, &attr);
+        pthread_mutexattr_destroy(&attr);
+        hdr->fEntries = nullptr;
+        memcpy(hdr->fMagic, kHeapMagic, sizeof(kHeapMagic));
+        mmalloc_setkey(md, 0, hdr);
+    }
+
+// publish; link() fails if path already exists
+    bool ok = hdr && link(tmp.c_str(), path.c_str()) == 0;
+    unlink(tmp.c_str());
+    if (!ok) {
+        if (md) mmalloc_detach(md);
+        close(fd);
+        return nullptr;
+    }
+
+    return register_heap(md, fd);
+}
+
+Cppyy::TCppHeap_t Cppyy::AttachSharedHeap(const std::string& path)
+{
+    declare_heap_allocator();
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0)
+        return nullptr;
+
+// an empty file would be initialized as a new, private, heap
+    struct stat sbuf;
+    void* md = nullptr;
+    if (fstat(fd, &sbuf) == 0 && 0 < sbuf.st_size)
+        md = mmalloc_attach(fd, nullptr, 0);   // fails if not at its original address
+
+    HeapHeader* hdr = heap_header(md);
+    if (!hdr || memcmp(hdr->fMagic, kHeapMagic, sizeof(kHeapMagic)) != 0) {
+        if (md) mmalloc_detach(md);
+        close(fd);
+        return nullptr;
+    }
+
+    return register_heap(md, fd);
+}
+
+void Cppyy::DetachSharedHeap(TCppHeap_t heap)
+{
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(gHeapFilesMutex);
+        auto ih = gHeapFiles.find(heap);
+        if (ih == gHeapFiles.end())
+            return;
+        fd = ih->second;
+        gHeapFiles.erase(ih);
+    }
+
+    if (gCurrentHeap == heap)
+        gCurrentHeap = nullptr;
+    mmalloc_detach(heap);
+    close(fd);
+}
+
+void* Cppyy::HeapAllocate(TCppHeap_t heap, size_t size)
+{
+    HeapHeader* hdr = heap_header(heap);
+    if (!hdr)
+        return nullptr;
+    HeapLock lock(hdr);
+    return mmalloc(heap, size);
+}
+
+void Cppyy::HeapDeallocate(TCppHeap_t heap, void* ptr)
+{
+    HeapHeader* hdr = heap_header(heap);
+    if (!hdr || !ptr)
+        return;
+    HeapLock lock(hdr);
+    mfree(heap, ptr);
+}
+
+Cppyy::TCppObject_t Cppyy::HeapConstruct(TCppHeap_t heap, TCppType_t type, const std::string& name)
+{
+    HeapHeader* hdr = heap_header(heap);
+    TClassRef& cr = type_from_handle(type);
+    if (!hdr || !cr.GetClass() || !cr->Size())
+        return (TCppObject_t)0;
+
+// vtable pointers are only valid in this process (see cpp_cppyy.h)
+    if (cr->ClassProperty() & kClassHasVirtual)
+        return (TCppObject_t)0;
+
+    HeapEntry* entry = nullptr;
+    if (!name.empty()) {
+        const std::string& tname = cr->GetName();
+        entry = (HeapEntry*)HeapAllocate(heap, sizeof(HeapEntry) + name.size() + tname.size() + 2);
+        if (!entry)
+            return (TCppObject_t)0;
+        entry->fName = (char*)(entry + 1);
+        entry->fType = entry->fName + name.size() + 1;
+        memcpy(entry->fName, name.c_str(), name.size() + 1);
+        memcpy(entry->fType, tname.c_str(), tname.size() + 1);
+    }
+
+// the lock is not held while constructing, as heap_allocator<T> takes it
+    void* arena = HeapAllocate(heap, (size_t)cr->Size());
+    void* obj = nullptr;
+    if (arena) {
+        CurrentHeap current(heap);
+        obj = Construct(type, arena);
+    }
+
+    if (!obj) {
+        HeapDeallocate(heap, arena);
+        HeapDeallocate(heap, entry);
+        return (TCppObject_t)0;
+    }
+
+    if (entry) {
+        HeapLock lock(hdr);
+        entry->fObject = obj;
+        entry->fNext = hdr->fEntries;
+        hdr->fEntries = entry;
+    }
+
+    return (TCppObject_t)obj;
+}
+
+void Cppyy::HeapDestruct(TCppHeap_t heap, TCppType_t type, TCppObject_t obj)
+{
+    HeapHeader* hdr = heap_header(heap);
+    TClassRef& cr = type_from_handle(type);
+    if (!hdr || !cr.GetClass() || !obj)
+        return;
+
+    {
+        HeapLock lock(hdr);
+        for (HeapEntry** pe = &hdr->fEntries; *pe; ) {
+            HeapEntry* entry = *pe;
+            if (entry->fObject == obj) {
+                *pe = entry->fNext;
+                mfree(heap, entry);
+            } else
+                pe = &entry->fNext;
+        }
+    }
+
+    {
+        CurrentHeap current(heap);
+        cr->Destructor((void*)obj, true /* dtor only */);
+    }
+    HeapDeallocate(heap, (void*)obj);
+}
+
+Cppyy::TCppObject_t Cppyy::HeapLookup(TCppHeap_t heap, const std::string& name, TCppType_t* type)
+{
+    HeapHeader* hdr = heap_header(heap);
+    if (!hdr)
+        return (TCppObject_t)0;
+
+    void* obj = nullptr;
+    std::string tname;
+    {
+        HeapLock lock(hdr);
+        for (HeapEntry* entry = hdr->fEntries; entry; entry = entry->fNext) {
+            if (name == entry->fName) {
+                obj = entry->fObject;
+                tname = entry->fType;
+                break;
+            }
+        }
+    }
+
+    if (obj && type)
+        *type = GetScope(tname);
+    return (TCppObject_t)obj;
+}
+
+#else
+
+Cppyy::TCppHeap_t Cppyy::CreateSharedHeap(const std::string&, size_t, void*) { return nullptr; }
+Cppyy::TCppHeap_t Cppyy::AttachSharedHeap(const std::string&) { return nullptr; }
+void Cppyy::DetachSharedHeap(TCppHeap_t) {}
+void* Cppyy::HeapAllocate(TCppHeap_t, size_t) { return nullptr; }
+void Cppyy::HeapDeallocate(TCppHeap_t, void*) {}
+Cppyy::TCppObject_t Cppyy::HeapConstruct(TCppHeap_t, TCppType_t, const std::string&) { return (TCppObject_t)0; }
+void Cppyy::HeapDestruct(TCppHeap_t, TCppType_t, TCppObject_t) {}
+Cppyy::TCppObject_t Cppyy::HeapLookup(TCppHeap_t, const std::string&, TCppType_t*) { return (TCppObject_t)0; }
+
+#endif // !WIN32
+
+Cppyy::TCppHeap_t Cppyy::SetCurrentHeap(TCppHeap_t heap)
+{
+    TCppHeap_t previous = gCurrentHeap;
+    gCurrentHeap = heap;
+    return previous;
+}
+
+Cppyy::TCppHeap_t Cppyy::GetCurrentHeap()
+{
+    return gCurrentHeap;
+}
+
+
 //- C-linkage wrappers -------------------------------------------------------
 
 extern "C" {
@@ -2628,9 +4126,20 @@ char* cppyy_resolve_enum(const char* enum_type) {
 }
 
 cppyy_scope_t cppyy_get_scope(const char* scope_name) {
+// look up memoized scopes directly, w/o creating a temporary std::string
+    Cppyy::TCppScope_t scope = find_memoized_scope(scope_name, strlen(scope_name));
+    if (scope) return cppyy_scope_t(scope);
     return cppyy_scope_t(Cppyy::GetScope(scope_name));
 }
 
+void cppyy_scope_miss_stats(unsigned long long* hits, unsigned long long* added, unsigned long long* flushes) {
+    unsigned long long h = 0, a = 0, f = 0;
+    Cppyy::GetScopeMissStats(h, a, f);
+    if (hits)    *hits    = h;
+    if (added)   *added   = a;
+    if (flushes) *flushes = f;
+}
+
 cppyy_type_t cppyy_actual_class(cppyy_type_t klass, cppyy_object_t obj) {
     return cppyy_type_t(Cppyy::GetActualClass(klass, (void*)obj));
 }
@@ -2776,6 +4285,36 @@ char* cppyy_call_s(
     return (char*)nullptr;
 }
 
+/* calls without exception translation for methods that can not throw; these
+   defer to the regular calls above for all other methods */
+int cppyy_is_noexcept(cppyy_method_t method) {
+    return (int)Cppyy::IsNoexcept(method);
+}
+
+void cppyy_call_v_noexcept(cppyy_method_t method, cppyy_object_t self, int nargs, void* args) {
+    if (!Cppyy::CallNoexcept(method, (void*)self, nargs, args, nullptr))
+        cppyy_call_v(method, self, nargs, args);
+}
+
+#define CPPYY_IMP_C_CALL_NOEXCEPT(name, rtype)                               \
+rtype cppyy_call_##name##_noexcept(                                          \
+        cppyy_method_t method, cppyy_object_t self, int nargs, void* args) { \
+    rtype r{};                                                               \
+    if (!Cppyy::CallNoexcept(method, (void*)self, nargs, args, &r))          \
+        return cppyy_call_##name(method, self, nargs, args);                 \
+    return r;                                                                \
+}
+
+CPPYY_IMP_C_CALL_NOEXCEPT(b,  unsigned char)
+CPPYY_IMP_C_CALL_NOEXCEPT(c,  char         )
+CPPYY_IMP_C_CALL_NOEXCEPT(h,  short        )
+CPPYY_IMP_C_CALL_NOEXCEPT(i,  int          )
+CPPYY_IMP_C_CALL_NOEXCEPT(l,  long         )
+CPPYY_IMP_C_CALL_NOEXCEPT(ll, long long    )
+CPPYY_IMP_C_CALL_NOEXCEPT(f,  float        )
+CPPYY_IMP_C_CALL_NOEXCEPT(d,  double       )
+CPPYY_IMP_C_CALL_NOEXCEPT(r,  void*        )
+
 cppyy_object_t cppyy_constructor(
         cppyy_method_t method, cppyy_type_t klass, int nargs, void* args) {
     try {
@@ -2796,10 +4335,39 @@ cppyy_object_t cppyy_call_o(cppyy_method_t method, cppyy_object_t self,
     return (cppyy_object_t)0;
 }
 
+#define CPPYY_IMP_C_CALL_BATCH(name, typecode, rtype)                        \
+int cppyy_call_##name##_batch(cppyy_method_t method, cppyy_object_t* selves,\
+        int nargs, void** args_columns, size_t* strides, size_t n, rtype* out) {\
+    try {                                                                    \
+        return (int)Cppyy::Call##typecode##Batch(method,                     \
+            (Cppyy::TCppObject_t*)selves, nargs, args_columns, strides, n, out);\
+    } catch (...) {                                                          \
+    /* no argument buffer to report through; the batch is incomplete */      \
+    }                                                                        \
+    return 0;                                                                \
+}
+
+CPPYY_IMP_C_CALL_BATCH(i,  I,  int      )
+CPPYY_IMP_C_CALL_BATCH(l,  L,  long     )
+CPPYY_IMP_C_CALL_BATCH(ll, LL, long long)
+CPPYY_IMP_C_CALL_BATCH(f,  F,  float    )
+CPPYY_IMP_C_CALL_BATCH(d,  D,  double   )
+
 cppyy_funcaddr_t cppyy_function_address(cppyy_method_t method) {
     return cppyy_funcaddr_t(Cppyy::GetFunctionAddress(method, true));
 }
 
+void cppyy_wait_for_wrappers() {
+    Cppyy::WaitForWrappers();
+}
+
+void cppyy_prepare_wrappers(cppyy_method_t* methods, int nmethods) {
+    std::vector<Cppyy::TCppMethod_t> v; v.reserve(nmethods);
+    for (int i = 0; i < nmethods; ++i)
+        v.push_back((Cppyy::TCppMethod_t)methods[i]);
+    Cppyy::PrepareWrappers(v);
+}
+
 
 /* handling of function argument buffer ----------------------------------- */
 void* cppyy_allocate_function_args(int nargs) {
@@ -2858,6 +4426,27 @@ const char** cppyy_get_all_cpp_names(cppyy_scope_t scope, size_t* count) {
     return c_cppnames;
 }
 
+const char** cppyy_get_all_cpp_names_packed(cppyy_scope_t scope, size_t* count) {
+    std::set<std::string> cppnames;
+    Cppyy::GetAllCppNames(scope, cppnames);
+
+// single allocation: the array of pointers, followed by the strings
+    size_t nbytes = cppnames.size()*sizeof(const char*);
+    for (const auto& name : cppnames)
+        nbytes += name.size()+1;
+    const char** c_cppnames = (const char**)malloc(nbytes ? nbytes : 1);
+    char* buf = (char*)(c_cppnames + cppnames.size());
+    int i = 0;
+    for (const auto& name : cppnames) {
+        memcpy(buf, name.c_str(), name.size()+1);
+        c_cppnames[i] = buf;
+        buf += name.size()+1;
+        ++i;
+    }
+    *count = cppnames.size();
+    return c_cppnames;
+}
+
 
 /* namespace reflection information --------------------------------------- */
 cppyy_scope_t* cppyy_get_using_namespaces(cppyy_scope_t scope) {
@@ -3141,6 +4730,117 @@ long long cppyy_get_enum_data_value(cppyy_enum_t e, cppyy_index_t idata) {
 }
 
 
+/* bulk reflection information -------------------------------------------- */
+static_assert(sizeof(cppyy_scope_desc_t) == sizeof(Cppyy::TCppScopeDesc_t) &&
+              sizeof(cppyy_method_desc_t) == sizeof(Cppyy::TCppMethodDesc_t) &&
+              sizeof(cppyy_arg_desc_t) == sizeof(Cppyy::TCppArgDesc_t) &&
+              sizeof(cppyy_datamember_desc_t) == sizeof(Cppyy::TCppDataDesc_t) &&
+              sizeof(cppyy_enum_desc_t) == sizeof(Cppyy::TCppEnumDesc_t) &&
+              sizeof(cppyy_enum_const_desc_t) == sizeof(Cppyy::TCppEnumConstDesc_t),
+              "C and C++ scope descriptions differ in layout");
+static_assert(offsetof(cppyy_scope_desc_t, enums) == offsetof(Cppyy::TCppScopeDesc_t, fEnums) &&
+              offsetof(cppyy_method_desc_t, property) == offsetof(Cppyy::TCppMethodDesc_t, fProperty) &&
+              (int)CPPYY_DESC_SMARTPTR == (int)Cppyy::kDescSmartPtr,
+              "C and C++ scope descriptions differ in layout");
+
+cppyy_scope_desc_t* cppyy_describe_scope(cppyy_scope_t scope) {
+    return (cppyy_scope_desc_t*)Cppyy::DescribeScope(scope);
+}
+
+
+/* instrumentation -------------------------------------------------------- */
+int cppyy_instrument_enable(int enable) {
+    return (int)Cppyy::EnableInstrumentation((bool)enable);
+}
+
+void cppyy_instrument_reset() {
+    Cppyy::ResetInstrumentation();
+}
+
+int cppyy_instrument_snapshot(cppyy_instrument_stat_t* stats, int nstats) {
+    int ncats = (int)TInstrumentation::kNumCategories;
+    for (int icat = 0; icat < ncats && icat < nstats; ++icat) {
+        TInstrumentation::ECategory cat = (TInstrumentation::ECategory)icat;
+        TInstrumentation::TStat stat = TInstrumentation::GetStat(cat);
+        stats[icat].category = TInstrumentation::GetCategoryName(cat);
+        stats[icat].count    = stat.fCount;
+        stats[icat].total_ns = stat.fTotalNs;
+        stats[icat].max_ns   = stat.fMaxNs;
+    }
+    return ncats;
+}
+
+char* cppyy_instrument_report() {
+    return cppstring_to_cstring(Cppyy::GetInstrumentationReport());
+}
+
+
+/* preloading (warm-up before fork()) ------------------------------------- */
+int cppyy_preload(const char** libraries, int nlibs, const char** scopes, int nscopes, int wrappers) {
+    std::vector<std::string> libs, names;
+    libs.reserve(nlibs); names.reserve(nscopes);
+    for (int i = 0; i < nlibs; ++i) libs.push_back(libraries[i]);
+    for (int i = 0; i < nscopes; ++i) names.push_back(scopes[i]);
+    return (int)Cppyy::Preload(libs, names, (bool)wrappers);
+}
+
+int cppyy_enable_fork_safety() {
+    return (int)Cppyy::EnableForkSafety();
+}
+
+
+/* serialization ---------------------------------------------------------- */
+int cppyy_serialize(cppyy_type_t type, cppyy_object_t obj, char** buf, size_t* len) {
+    return (int)Cppyy::Serialize(type, (void*)obj, buf, len);
+}
+
+cppyy_object_t cppyy_deserialize(cppyy_type_t type, const char* buf, size_t len, void* arena) {
+    return (cppyy_object_t)Cppyy::Deserialize(type, buf, len, arena);
+}
+
+
+/* shared-memory heaps ---------------------------------------------------- */
+cppyy_heap_t cppyy_create_shared_heap(const char* path, size_t size, void* base) {
+    return Cppyy::CreateSharedHeap(path, size, base);
+}
+
+cppyy_heap_t cppyy_attach_shared_heap(const char* path) {
+    return Cppyy::AttachSharedHeap(path);
+}
+
+void cppyy_detach_shared_heap(cppyy_heap_t heap) {
+    Cppyy::DetachSharedHeap(heap);
+}
+
+void* cppyy_heap_allocate(cppyy_heap_t heap, size_t size) {
+    return Cppyy::HeapAllocate(heap, size);
+}
+
+void cppyy_heap_deallocate(cppyy_heap_t heap, void* ptr) {
+    Cppyy::HeapDeallocate(heap, ptr);
+}
+
+cppyy_object_t cppyy_heap_construct(cppyy_heap_t heap, cppyy_type_t type, const char* name) {
+    return (cppyy_object_t)Cppyy::HeapConstruct(heap, type, name ? name : "");
+}
+
+void cppyy_heap_destruct(cppyy_heap_t heap, cppyy_type_t type, cppyy_object_t obj) {
+    Cppyy::HeapDestruct(heap, type, (void*)obj);
+}
+
+cppyy_object_t cppyy_heap_lookup(cppyy_heap_t heap, const char* name, cppyy_type_t* type) {
+    return (cppyy_object_t)Cppyy::HeapLookup(heap, name, type);
+}
+
+cppyy_heap_t cppyy_set_current_heap(cppyy_heap_t heap) {
+    return Cppyy::SetCurrentHeap(heap);
+}
+
+cppyy_heap_t cppyy_current_heap() {
+    return Cppyy::GetCurrentHeap();
+}
+
+
 /* misc helpers ----------------------------------------------------------- */
 RPY_EXTERN
 void* cppyy_load_dictionary(const char* lib_name) {
@@ -39,6 +39,7 @@ namespace Cppyy {
 
     typedef size_t      TCppIndex_t;
     typedef void*       TCppFuncAddr_t;
+    typedef void*       TCppHeap_t;
 
 // direct interpreter access -------------------------------------------------
     RPY_EXPORTED
@@ -54,6 +55,9 @@ namespace Cppyy {
     RPY_EXPORTED
     TCppScope_t GetScope(const std::string& scope_name);
     RPY_EXPORTED
+    void        GetScopeMissStats(
+        unsigned long long& hits, unsigned long long& added, unsigned long long& flushes);
+    RPY_EXPORTED
     TCppType_t  GetActualClass(TCppType_t klass, TCppObject_t obj);
     RPY_EXPORTED
     size_t      SizeOf(TCppType_t klass);
@@ -100,6 +104,11 @@ namespace Cppyy {
     RPY_EXPORTED
     PY_LONG_DOUBLE CallLD(TCppMethod_t method, TCppObject_t self, size_t nargs, void* args);
 
+    RPY_EXPORTED
+    bool          IsNoexcept(TCppMethod_t method);
+    RPY_EXPORTED
+    bool          CallNoexcept(TCppMethod_t method, TCppObject_t self, size_t nargs, void* args, void* result);
+
     RPY_EXPORTED
     void*         CallR(TCppMethod_t method, TCppObject_t self, size_t nargs, void* args);
     RPY_EXPORTED
@@ -111,8 +120,33 @@ namespace Cppyy {
     RPY_EXPORTED
     TCppObject_t  CallO(TCppMethod_t method, TCppObject_t self, size_t nargs, void* args, TCppType_t result_type);
 
+// bulk calls: arguments are taken from per-argument columns (strided arrays),
+// with results written consecutively (or at out_stride) into out
+    RPY_EXPORTED
+    bool          CallBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, void* out, size_t out_stride);
+    RPY_EXPORTED
+    bool          CallIBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, int* out);
+    RPY_EXPORTED
+    bool          CallLBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, long* out);
+    RPY_EXPORTED
+    bool          CallLLBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, PY_LONG_LONG* out);
+    RPY_EXPORTED
+    bool          CallFBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, float* out);
+    RPY_EXPORTED
+    bool          CallDBatch(TCppMethod_t method, TCppObject_t* selves, size_t nargs,
+                      void** columns, const size_t* strides, size_t n, double* out);
+
     RPY_EXPORTED
     TCppFuncAddr_t GetFunctionAddress(TCppMethod_t method, bool check_enabled=true);
+    RPY_EXPORTED
+    void           PrepareWrappers(const std::vector<TCppMethod_t>& methods);
+    RPY_EXPORTED
+    void           WaitForWrappers();
 
 // handling of function argument buffer --------------------------------------
     RPY_EXPORTED
@@ -285,6 +319,139 @@ namespace Cppyy {
     RPY_EXPORTED
     long long   GetEnumDataValue(TCppEnum_t, TCppIndex_t idata);
 
+// bulk reflection information -----------------------------------------------
+// A scope description lives in a single block of memory, strings included, so
+// that it can be released with a single free(); all pointers refer into it.
+    enum EDescProperty {
+        kDescPublic          = 0x0001,
+        kDescProtected       = 0x0002,
+        kDescStatic          = 0x0004,
+        kDescConst           = 0x0008,
+        kDescConstructor     = 0x0010,
+        kDescDestructor      = 0x0020,
+        kDescExplicit        = 0x0040,
+        kDescEnumData        = 0x0080,
+        kDescNamespace       = 0x0100,
+        kDescAbstract        = 0x0200,
+        kDescAggregate       = 0x0400,
+        kDescDefaultCtor     = 0x0800,
+        kDescVirtualDtor     = 0x1000,
+        kDescComplex         = 0x2000,
+        kDescSmartPtr        = 0x4000
+    };
+
+    struct TCppArgDesc_t {
+        const char*     fName;
+        const char*     fType;
+        const char*     fDefault;         // empty if none
+    };
+
+    struct TCppMethodDesc_t {
+        TCppMethod_t    fMethod;
+        const char*     fName;
+        const char*     fResultType;
+        TCppArgDesc_t*  fArgs;
+        unsigned int    fNArgs;
+        unsigned int    fReqArgs;
+        unsigned int    fProperty;        // EDescProperty bits
+    };
+
+    struct TCppDataDesc_t {
+        const char*     fName;
+        const char*     fType;
+        intptr_t        fOffset;          // -1 for non-public static data
+        unsigned int    fProperty;
+    };
+
+    struct TCppEnumConstDesc_t {
+        const char*     fName;
+        long long       fValue;
+    };
+
+    struct TCppEnumDesc_t {
+        TCppEnum_t      fEnum;
+        const char*     fName;
+        TCppEnumConstDesc_t* fConstants;
+        unsigned int    fNConstants;
+    };
+
+    struct TCppScopeDesc_t {
+        TCppScope_t     fScope;
+        const char*     fName;            // final name
+        const char*     fScopedName;
+        size_t          fSize;
+        unsigned int    fProperty;
+        unsigned int    fNBases;
+        const char**    fBases;
+        unsigned int    fNMethods;        // indices as for GetMethod()
+        TCppMethodDesc_t* fMethods;
+        unsigned int    fNDatamembers;    // indices as for GetDatamemberName() etc.
+        TCppDataDesc_t* fDatamembers;
+        unsigned int    fNEnums;
+        TCppEnumDesc_t* fEnums;
+    };
+
+    RPY_EXPORTED
+    TCppScopeDesc_t* DescribeScope(TCppScope_t scope);
+
+// instrumentation -----------------------------------------------------------
+    RPY_EXPORTED
+    bool        EnableInstrumentation(bool enable);     // returns previous state
+    RPY_EXPORTED
+    void        ResetInstrumentation();
+    RPY_EXPORTED
+    std::string GetInstrumentationReport();
+
+// preloading (warm-up before fork()) ------------------------------------------
+    RPY_EXPORTED
+    bool Preload(const std::vector<std::string>& libraries,
+        const std::vector<std::string>& scopes, bool wrappers = true);
+    RPY_EXPORTED
+    bool EnableForkSafety();            // returns false if not supported
+
+// serialization --------------------------------------------------------------
+// Serialize() streams into *buf if given (*len is its capacity; on false, *len
+// is the required size), else into a per-thread buffer, which stays valid until
+// the next call on the same thread; Deserialize() constructs the object in arena
+// if given (at least SizeOf(type) large), else allocates it
+    RPY_EXPORTED
+    bool         Serialize(TCppType_t type, TCppObject_t obj, char** buf, size_t* len);
+    RPY_EXPORTED
+    TCppObject_t Deserialize(TCppType_t type, const char* buf, size_t len, void* arena = nullptr);
+
+// shared-memory heaps ---------------------------------------------------------
+// A heap is a file-backed mmap region (e.g. under /dev/shm), managed by the clib
+// mapped-malloc allocator and mapped at the same address in all processes that
+// attach it, so that pointers into it stay valid. Objects constructed in a heap
+// can be registered under a name, for lookup from other processes. During
+// HeapConstruct() and HeapDestruct() the heap is current on the calling thread,
+// which is where cppyy::heap_allocator<T> allocates, so that containers that use
+// it as their allocator place their elements in the same heap (the allocator is
+// declared to the interpreter on the first CreateSharedHeap/AttachSharedHeap).
+// Polymorphic types can not be placed in a heap (HeapConstruct() refuses them):
+// their vtable pointers refer to the code of the creating process, which, with
+// address space randomization, is mapped elsewhere in other processes.
+    RPY_EXPORTED
+    TCppHeap_t   CreateSharedHeap(const std::string& path, size_t size, void* base = nullptr);
+    RPY_EXPORTED
+    TCppHeap_t   AttachSharedHeap(const std::string& path);
+    RPY_EXPORTED
+    void         DetachSharedHeap(TCppHeap_t heap);
+    RPY_EXPORTED
+    void*        HeapAllocate(TCppHeap_t heap, size_t size);
+    RPY_EXPORTED
+    void         HeapDeallocate(TCppHeap_t heap, void* ptr);
+    RPY_EXPORTED
+    TCppObject_t HeapConstruct(TCppHeap_t heap, TCppType_t type, const std::string& name = "");
+    RPY_EXPORTED
+    void         HeapDestruct(TCppHeap_t heap, TCppType_t type, TCppObject_t obj);
+    RPY_EXPORTED
+    TCppObject_t HeapLookup(TCppHeap_t heap, const std::string& name, TCppType_t* type = nullptr);
+    RPY_EXPORTED
+    TCppHeap_t   SetCurrentHeap(TCppHeap_t heap);     // returns the previous one
+    RPY_EXPORTED
+    TCppHeap_t   GetCurrentHeap();
+
 } // namespace Cppyy
 
 #endif // !CPYCPPYY_CPPYY_H
@@ -0,0 +1,154 @@
+#ifndef CPPYY_NAMETABLE
+#define CPPYY_NAMETABLE
+
+// Standard
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+
+namespace Cppyy {
+
+// Hashed table of interned names; lookups take (const char*, length) so that
+// neither C strings nor sub-strings need to be copied into a temporary
+// std::string first. Entries are never removed and their names never move,
+// so the interned strings can be referenced for the life time of the table.
+template<typename V>
+class NameTable {
+public:
+    struct Entry {
+        Entry(const char* name, size_t len, size_t hash) : fName(name, len), fHash(hash), fValue() {}
+        std::string fName;
+        size_t      fHash;
+        V           fValue;
+    };
+    typedef typename std::deque<Entry>::const_iterator const_iterator;
+
+public:
+    NameTable() : fSlots(16, nullptr) {}
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    static size_t Hash(const char* name, size_t len) {
+    // FNV-1a
+        size_t h = (size_t)14695981039346656037ULL;
+        for (size_t i = 0; i < len; ++i) {
+            h ^= (unsigned char)name[i];
+            h *= (size_t)1099511628211ULL;
+        }
+        return h;
+    }
+
+    V* find(const char* name, size_t len) const {
+        return find(name, len, Hash(name, len));
+    }
+    V* find(const char* name, size_t len, size_t hash) const {
+        Entry* e = fSlots[probe(name, len, hash)];
+        return e ? &e->fValue : nullptr;
+    }
+    V* find(const char* name) const { return find(name, strlen(name)); }
+    V* find(const std::string& name) const { return find(name.data(), name.size()); }
+
+    V& get(const char* name, size_t len) {
+    // return the value for name, inserting a default one if not yet there
+        return get_entry(name, len).fValue;
+    }
+    V& operator[](const char* name) { return get(name, strlen(name)); }
+    V& operator[](const std::string& name) { return get(name.data(), name.size()); }
+
+    const std::string& intern(const char* name, size_t len) {
+    // return the stable copy of name, adding it if not yet there
+        return get_entry(name, len).fName;
+    }
+
+    void clear() {
+        fEntries.clear();
+        fSlots.assign(16, nullptr);
+    }
+
+    size_t size() const { return fEntries.size(); }
+    bool empty() const { return fEntries.empty(); }
+    const_iterator begin() const { return fEntries.begin(); }
+    const_iterator end() const { return fEntries.end(); }
+
+private:
+    Entry& get_entry(const char* name, size_t len) {
+        size_t hash = Hash(name, len);
+        size_t islot = probe(name, len, hash);
+        if (fSlots[islot])
+            return *fSlots[islot];
+
+        fEntries.emplace_back(name, len, hash);
+        Entry& e = fEntries.back();
+        fSlots[islot] = &e;
+        if (fEntries.size() * 4 > fSlots.size() * 3)
+            rehash();
+        return e;
+    }
+
+    size_t probe(const char* name, size_t len, size_t hash) const {
+    // linear probing; the table is never more than 3/4 full, so this terminates
+        size_t mask = fSlots.size() - 1;
+        size_t islot = hash & mask;
+        while (Entry* e = fSlots[islot]) {
+            if (e->fHash == hash && e->fName.size() == len && memcmp(e->fName.data(), name, len) == 0)
+                break;
+            islot = (islot + 1) & mask;
+        }
+        return islot;
+    }
+
+    void rehash() {
+        std::vector<Entry*> slots(fSlots.size() * 2, nullptr);
+        size_t mask = slots.size() - 1;
+        for (auto& e : fEntries) {
+            size_t islot = e.fHash & mask;
+            while (slots[islot]) islot = (islot + 1) & mask;
+            slots[islot] = &e;
+        }
+        fSlots.swap(slots);
+    }
+
+private:
+    std::deque<Entry>   fEntries;       // owns the entries, in insertion order
+    std::vector<Entry*> fSlots;         // open addressing, size is a power of 2
+};
+
+// Set of interned names, with the same lookup interface as NameTable.
+class NameSet {
+public:
+    typedef NameTable<bool>::const_iterator const_iterator;
+
+public:
+    NameSet() = default;
+    NameSet(std::initializer_list<const char*> names) {
+        for (auto name : names) insert(name);
+    }
+
+    bool contains(const char* name, size_t len) const {
+        bool* b = fTable.find(name, len);
+        return b && *b;
+    }
+    bool contains(const char* name) const { return contains(name, strlen(name)); }
+    bool contains(const std::string& name) const { return contains(name.data(), name.size()); }
+
+    void insert(const char* name, size_t len) { fTable.get(name, len) = true; }
+    void insert(const char* name) { insert(name, strlen(name)); }
+    void insert(const std::string& name) { insert(name.data(), name.size()); }
+
+    void clear() { fTable.clear(); }
+
+    size_t size() const { return fTable.size(); }
+    bool empty() const { return fTable.empty(); }
+    const_iterator begin() const { return fTable.begin(); }
+    const_iterator end() const { return fTable.end(); }
+
+private:
+    NameTable<bool> fTable;
+};
+
+} // namespace Cppyy
+
+#endif // !CPPYY_NAMETABLE